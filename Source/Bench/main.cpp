@@ -0,0 +1,303 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// rmg-bench runs a single ROM for a fixed amount of frames
+// without the speed limiter and without any window,
+// then writes the results as one line of JSON.
+//
+// the core and the video plugins print to stdout as well,
+// so use --output when the result has to be parsed.
+//
+// the core runs on its own config directory, a temporary copy
+// of RMG's unless --config-dir is given, so nothing a run
+// changes ends up in the user's config or saves. RMG's own
+// settings are reset to their defaults there, the core's and
+// the plugins' sections are kept, pin those with --setting
+// to get comparable runs.
+//
+
+#include <Config.hpp>
+#include <Globals.hpp>
+#include <M64P/Wrapper/VidExt.hpp>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <cstdlib>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+static qint64 GetPeakMemory(void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static bool SetAffinity(int cpu)
+{
+#ifdef _WIN32
+    return SetProcessAffinityMask(GetCurrentProcess(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+// <section>/<key>=<value>, the value type is guessed
+static bool SetOption(QString option)
+{
+    int keyIndex = option.indexOf('/');
+    int valueIndex = option.indexOf('=');
+    bool isInt = false;
+
+    if (keyIndex <= 0 || valueIndex <= keyIndex + 1)
+        return false;
+
+    QString section = option.left(keyIndex);
+    QString key = option.mid(keyIndex + 1, valueIndex - keyIndex - 1);
+    QString value = option.mid(valueIndex + 1);
+
+    int intValue = value.toInt(&isInt);
+    if (isInt)
+        return g_MupenApi.Config.SetOption(section, key, intValue);
+
+    if (value == "true" || value == "false")
+        return g_MupenApi.Config.SetOption(section, key, value == "true");
+
+    return g_MupenApi.Config.SetOption(section, key, value);
+}
+
+static int WriteResult(QString file, QJsonObject result)
+{
+    QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Compact);
+
+    if (file.isEmpty())
+    {
+        std::cout << std::endl << json.toStdString() << std::endl;
+    }
+    else
+    {
+        QFile output(file);
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            std::cerr << "QFile::open(" << file.toStdString() << ") Failed" << std::endl;
+            return 1;
+        }
+        output.write(json + "\n");
+    }
+
+    return result["success"].toBool() ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    QCommandLineParser parser;
+    QJsonObject result;
+    QElapsedTimer timer;
+    QTemporaryDir tempDir;
+    QString configDir;
+    RomInfo_t romInfo = {0};
+    PluginType pluginTypes[] = {PluginType::Gfx, PluginType::Audio, PluginType::Input, PluginType::Rsp};
+    QString pluginOptions[] = {"gfx", "audio", "input", "rsp"};
+    quint64 frames;
+
+    parser.setApplicationDescription("Runs a ROM without the speed limiter and reports its speed as JSON");
+    parser.addHelpOption();
+    parser.addPositionalArgument("rom", "ROM file to run");
+    parser.addOption({{"f", "frames"}, "Amount of frames to run", "frames", QString::number(APP_BENCH_FRAMES)});
+    parser.addOption({{"o", "output"}, "Write the JSON to <file> instead of stdout", "file"});
+    parser.addOption({{"c", "cpu"}, "Pin the process to <cpu> before loading anything", "cpu"});
+    parser.addOption({{"s", "setting"}, "Override a core or plugin setting", "section/key=value"});
+    parser.addOption({"config-dir", "Use <dir> for the config and saves instead of a temporary copy", "dir"});
+    parser.addOption({"gfx", "GFX plugin to use", "file"});
+    parser.addOption({"audio", "Audio plugin to use", "file"});
+    parser.addOption({"input", "Input plugin to use", "file"});
+    parser.addOption({"rsp", "RSP plugin to use", "file"});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    // relative paths are relative to the caller,
+    // everything else to our install directory
+    QString romFile = QFileInfo(parser.positionalArguments().first()).absoluteFilePath();
+    QString outputFile = parser.value("output");
+    if (!outputFile.isEmpty())
+        outputFile = QFileInfo(outputFile).absoluteFilePath();
+    for (QString &option : pluginOptions)
+    {
+        if (parser.isSet(option))
+            option = QFileInfo(parser.value(option)).absoluteFilePath();
+        else
+            option.clear();
+    }
+
+    if (parser.isSet("config-dir"))
+        configDir = QFileInfo(parser.value("config-dir")).absoluteFilePath();
+    else
+        configDir = tempDir.path();
+
+    frames = parser.value("frames").toULongLong();
+
+    QDir::setCurrent(app.applicationDirPath());
+
+    result["rom"] = romFile;
+    result["success"] = false;
+
+    if (frames == 0)
+    {
+        result["error"] = "invalid frame count: " + parser.value("frames");
+        return WriteResult(outputFile, result);
+    }
+
+    // threads inherit the affinity,
+    // so this covers the plugins' threads too
+    if (parser.isSet("cpu") && !SetAffinity(parser.value("cpu").toInt()))
+        std::cerr << "SetAffinity(" << parser.value("cpu").toStdString() << ") Failed" << std::endl;
+
+    // every setting change saves the config, so start
+    // from a copy and leave the user's config alone
+    if (configDir.isEmpty() || !QDir().mkpath(configDir))
+    {
+        result["error"] = "failed to create config directory: " + configDir;
+        return WriteResult(outputFile, result);
+    }
+
+    if (!QFile::exists(configDir + "/mupen64plus.cfg"))
+        QFile::copy(MUPEN_CONFIG_DIR "/mupen64plus.cfg", configDir + "/mupen64plus.cfg");
+
+    if (!g_MupenApi.Init(MUPEN_CORE_FILE, configDir))
+    {
+        result["error"] = g_MupenApi.GetLastError();
+        return WriteResult(outputFile, result);
+    }
+
+    // RMG's settings start from their defaults, not from
+    // whatever the user configured, the saves go next
+    // to the config so runs don't touch the user's
+    g_Settings.LoadDefaults();
+    g_Settings.RestoreDefaults();
+    g_Settings.SetValue(SettingsID::Core_SaveStatePath, configDir + "/Save/State");
+    g_Settings.SetValue(SettingsID::Core_SaveSRAMPath, configDir + "/Save/Game");
+
+    for (const QString &option : parser.values("setting"))
+    {
+        if (!SetOption(option))
+        {
+            result["error"] = "invalid setting: " + option;
+            return WriteResult(outputFile, result);
+        }
+    }
+
+    g_Plugins.LoadSettings();
+    g_Plugins.WaitForProbe();
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (pluginOptions[i].isEmpty())
+            continue;
+
+        if (!g_MupenApi.Core.SetPlugin({.FileName = pluginOptions[i], .Type = pluginTypes[i]}))
+        {
+            result["error"] = g_MupenApi.Core.GetLastError();
+            return WriteResult(outputFile, result);
+        }
+    }
+
+    if (!g_MupenApi.Core.GetRomInfo(romFile, &romInfo, true))
+    {
+        result["error"] = g_MupenApi.Core.GetLastError();
+        return WriteResult(outputFile, result);
+    }
+
+    VidExt_SetHeadless(true);
+    g_MupenApi.Core.DisableSpeedLimiter();
+    g_MupenApi.Core.SetFrameLimit(frames);
+
+    // the emulation thread needs our event loop for the
+    // offscreen surface, so run it like RMG does
+    g_EmuThread = new Thread::EmulationThread();
+    g_EmuThread->SetRomFile(romFile);
+
+    QObject::connect(g_EmuThread, &Thread::EmulationThread::on_Emulation_Finished, &app, &QGuiApplication::quit,
+                     Qt::QueuedConnection);
+
+    timer.start();
+    g_EmuThread->start();
+    app.exec();
+    g_EmuThread->wait();
+
+    double wallTime = timer.nsecsElapsed() / 1000000000.0;
+    quint64 viCount = g_MupenApi.Core.GetFrameCount();
+    quint32 frameCount = VidExt_GetFrameStats()->GetFrameCount();
+    double viRate = g_MupenApi.Core.GetRomViRate(&romInfo);
+
+    const char *name = (const char *)romInfo.Header.Name;
+    result["name"] = QString::fromLatin1(name, qstrnlen(name, sizeof(romInfo.Header.Name))).trimmed();
+    result["vi_rate"] = viRate;
+    result["vi_count"] = (qint64)viCount;
+    result["frame_count"] = (qint64)frameCount;
+    result["wall_time"] = wallTime;
+    result["vi_per_second"] = viCount / wallTime;
+    result["fps"] = frameCount / wallTime;
+    result["speed"] = ((viCount / wallTime) * 100.0) / viRate;
+    result["frame_times"] = VidExt_GetFrameStats()->GetSummary();
+    result["peak_rss"] = GetPeakMemory();
+
+    if (!g_EmuThread->GetLastError().isEmpty())
+        result["error"] = g_EmuThread->GetLastError();
+    else if (viCount < frames)
+        result["error"] = "emulation stopped after " + QString::number(viCount) + " frames";
+    else
+        result["success"] = true;
+
+    int ret = WriteResult(outputFile, result);
+
+    // _Exit skips the destructor
+    if (tempDir.isValid())
+        tempDir.remove();
+
+    // like RMG-PluginProbe, skip the plugins' static destructors
+    std::cout.flush();
+    _Exit(ret);
+}
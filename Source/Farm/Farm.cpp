@@ -0,0 +1,389 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Farm.hpp"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <iostream>
+
+Farm::Farm(void)
+{
+}
+
+Farm::~Farm(void)
+{
+}
+
+bool Farm::AddRoms(QString path)
+{
+    QFileInfo info(path);
+
+    if (!info.exists())
+    {
+        this->error_Message = "Farm::AddRoms: " + path + " doesn't exist";
+        return false;
+    }
+
+    if (info.isDir())
+        return this->rom_AddDirectory(info.absoluteFilePath());
+
+    if (info.suffix().toLower() == "txt" || info.suffix().toLower() == "lst")
+        return this->rom_AddList(info.absoluteFilePath());
+
+    this->rom_List.append(info.absoluteFilePath());
+    return true;
+}
+
+bool Farm::AddProfile(QString file)
+{
+    QFile profileFile(file);
+    FarmProfile_t profile;
+
+    if (!profileFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        this->error_Message = "Farm::AddProfile: QFile::open(" + file + ") Failed";
+        return false;
+    }
+
+    // one rmg-bench argument per line
+    profile.Name = QFileInfo(file).completeBaseName();
+    while (!profileFile.atEnd())
+    {
+        QString line = QString::fromUtf8(profileFile.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        profile.Arguments.append(line);
+    }
+
+    this->profile_List.append(profile);
+    return true;
+}
+
+void Farm::SetBenchFile(QString file)
+{
+    this->bench_File = file;
+}
+
+void Farm::SetLogDirectory(QString directory)
+{
+    this->log_Directory = directory;
+}
+
+void Farm::SetWorkerCount(int count)
+{
+    this->worker_Count = qMax(1, count);
+}
+
+void Farm::SetFrames(quint64 frames)
+{
+    this->bench_Frames = frames;
+}
+
+void Farm::SetTimeout(int seconds)
+{
+    this->bench_Timeout = seconds;
+}
+
+bool Farm::Run(void)
+{
+    int workers;
+
+    if (this->rom_List.isEmpty())
+    {
+        this->error_Message = "Farm::Run: no ROMs to run";
+        return false;
+    }
+
+    if (!this->output_Directory.isValid())
+    {
+        this->error_Message = "Farm::Run: QTemporaryDir Failed: " + this->output_Directory.errorString();
+        return false;
+    }
+
+    if (!this->log_Directory.isEmpty() && !QDir().mkpath(this->log_Directory))
+    {
+        this->error_Message = "Farm::Run: QDir::mkpath(" + this->log_Directory + ") Failed";
+        return false;
+    }
+
+    if (this->profile_List.isEmpty())
+        this->profile_List.append({"default", QStringList()});
+
+    for (const QString &rom : this->rom_List)
+    {
+        for (const FarmProfile_t &profile : this->profile_List)
+            this->job_Queue.append({this->job_Total++, rom, profile});
+    }
+
+    workers = qMin(this->worker_Count, this->job_Total);
+
+    std::cerr << "Farm: " << this->job_Total << " runs on " << workers << " workers" << std::endl;
+
+    // start from within the event loop,
+    // a worker failing to start can finish right away
+    QTimer::singleShot(0, [this, workers]() {
+        for (int i = 0; i < workers; i++)
+            this->worker_Start(i);
+    });
+
+    this->run_Timer.start();
+    this->event_Loop.exec();
+
+    std::sort(this->job_Results.begin(), this->job_Results.end(),
+              [](const FarmResult_t &a, const FarmResult_t &b) { return a.Job.Index < b.Job.Index; });
+
+    return true;
+}
+
+bool Farm::WriteReport(QString file)
+{
+    if (file.endsWith(".csv", Qt::CaseInsensitive))
+        return this->report_WriteCsv(file);
+
+    return this->report_WriteJson(file);
+}
+
+QString Farm::GetLastError(void)
+{
+    return this->error_Message;
+}
+
+bool Farm::rom_AddList(QString file)
+{
+    QFile listFile(file);
+    QDir listDir = QFileInfo(file).absoluteDir();
+
+    if (!listFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        this->error_Message = "Farm::rom_AddList: QFile::open(" + file + ") Failed";
+        return false;
+    }
+
+    // one ROM (or directory) per line,
+    // relative to the list itself
+    while (!listFile.atEnd())
+    {
+        QString line = QString::fromUtf8(listFile.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        if (!this->AddRoms(listDir.absoluteFilePath(line)))
+            return false;
+    }
+
+    return true;
+}
+
+bool Farm::rom_AddDirectory(QString directory)
+{
+    QStringList filter;
+    filter << "*.N64";
+    filter << "*.Z64";
+    filter << "*.V64";
+
+    QDirIterator iterator(directory, filter, QDir::Files, QDirIterator::Subdirectories);
+    QStringList roms;
+
+    while (iterator.hasNext())
+        roms.append(iterator.next());
+
+    roms.sort();
+    this->rom_List.append(roms);
+    return true;
+}
+
+void Farm::worker_Start(int worker)
+{
+    if (this->job_Queue.isEmpty())
+    {
+        if (this->job_Running == 0)
+            this->event_Loop.quit();
+        return;
+    }
+
+    FarmJob_t job = this->job_Queue.takeFirst();
+    QString outputFile = this->output_Directory.filePath(QString::number(job.Index) + ".json");
+    QString configDir = this->output_Directory.filePath(QString::number(job.Index));
+    QProcess *process = new QProcess();
+    QStringList arguments;
+
+    arguments << job.Rom;
+    arguments << "--frames" << QString::number(this->bench_Frames);
+    arguments << "--output" << outputFile;
+    arguments << "--cpu" << QString::number(worker % QThread::idealThreadCount());
+    // every run starts from its own copy of the config, with
+    // its own saves, so profiles can't leak into each other
+    // and a killed run doesn't leave anything behind
+    arguments << "--config-dir" << configDir;
+    arguments << job.Profile.Arguments;
+
+    // the core and plugins are chatty,
+    // only keep their output when asked to
+    if (this->log_Directory.isEmpty())
+    {
+        process->setStandardOutputFile(QProcess::nullDevice());
+        process->setStandardErrorFile(QProcess::nullDevice());
+    }
+    else
+    {
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        process->setStandardOutputFile(QDir(this->log_Directory).filePath(QString::number(job.Index) + ".log"));
+    }
+
+    QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                     [=](int, QProcess::ExitStatus) { this->worker_Finished(worker, job, process, outputFile); });
+    QObject::connect(process, &QProcess::errorOccurred, [=](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            this->worker_Finished(worker, job, process, outputFile);
+    });
+
+    if (this->bench_Timeout > 0)
+    {
+        QTimer *timer = new QTimer(process);
+        timer->setSingleShot(true);
+        QObject::connect(timer, &QTimer::timeout, process, [process]() {
+            process->setProperty("timedOut", true);
+            process->kill();
+        });
+        timer->start(this->bench_Timeout * 1000);
+    }
+
+    this->job_Running++;
+    process->start(this->bench_File, arguments);
+}
+
+void Farm::worker_Finished(int worker, FarmJob_t job, QProcess *process, QString outputFile)
+{
+    FarmResult_t result = {job, QString(), -1, QJsonObject()};
+    QFile file(outputFile);
+
+    if (file.open(QIODevice::ReadOnly))
+        result.Bench = QJsonDocument::fromJson(file.readAll()).object();
+
+    if (process->error() == QProcess::FailedToStart)
+    {
+        result.Status = "error";
+        result.Bench["error"] = process->errorString();
+    }
+    else if (process->property("timedOut").toBool())
+    {
+        result.Status = "timeout";
+    }
+    else if (process->exitStatus() == QProcess::CrashExit || result.Bench.isEmpty())
+    {
+        result.Status = "crashed";
+        result.ExitCode = process->exitCode();
+    }
+    else
+    {
+        result.Status = result.Bench["success"].toBool() ? "ok" : "failed";
+        result.ExitCode = process->exitCode();
+    }
+
+    this->job_Results.append(result);
+    this->job_Running--;
+
+    std::cerr << "[" << this->job_Results.size() << "/" << this->job_Total << "] " << result.Status.toStdString()
+              << " " << QFileInfo(job.Rom).fileName().toStdString() << " (" << job.Profile.Name.toStdString() << ")";
+    if (result.Bench.contains("speed"))
+        std::cerr << " " << QString::number(result.Bench["speed"].toDouble(), 'f', 1).toStdString() << "%";
+    std::cerr << std::endl;
+
+    process->deleteLater();
+
+    this->worker_Start(worker);
+}
+
+bool Farm::report_WriteJson(QString file)
+{
+    QJsonObject report;
+    QJsonObject summary;
+    QJsonArray results;
+    QFile reportFile(file);
+
+    for (const FarmResult_t &result : this->job_Results)
+    {
+        QJsonObject object = result.Bench;
+        object["rom"] = result.Job.Rom;
+        object["profile"] = result.Job.Profile.Name;
+        object["status"] = result.Status;
+        object["exit_code"] = result.ExitCode;
+        object.remove("success");
+        results.append(object);
+
+        summary[result.Status] = summary[result.Status].toInt() + 1;
+    }
+
+    report["frames"] = (qint64)this->bench_Frames;
+    report["workers"] = this->worker_Count;
+    report["wall_time"] = this->run_Timer.nsecsElapsed() / 1000000000.0;
+    report["summary"] = summary;
+    report["results"] = results;
+
+    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        this->error_Message = "Farm::report_WriteJson: QFile::open(" + file + ") Failed";
+        return false;
+    }
+
+    reportFile.write(QJsonDocument(report).toJson());
+    return true;
+}
+
+bool Farm::report_WriteCsv(QString file)
+{
+    QStringList columns = {"rom",      "profile",       "status", "exit_code", "name",      "vi_rate", "vi_count",
+                           "frame_count", "wall_time", "vi_per_second", "fps", "speed", "peak_rss", "error"};
+    QFile reportFile(file);
+
+    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        this->error_Message = "Farm::report_WriteCsv: QFile::open(" + file + ") Failed";
+        return false;
+    }
+
+    QTextStream stream(&reportFile);
+    stream << columns.join(',') << "\n";
+
+    for (const FarmResult_t &result : this->job_Results)
+    {
+        QJsonObject object = result.Bench;
+        object["rom"] = result.Job.Rom;
+        object["profile"] = result.Job.Profile.Name;
+        object["status"] = result.Status;
+        object["exit_code"] = result.ExitCode;
+
+        QStringList row;
+        for (const QString &column : columns)
+        {
+            QJsonValue value = object.value(column);
+            QString text = value.isDouble() ? QString::number(value.toDouble(), 'g', 10) : value.toString();
+
+            if (text.contains(',') || text.contains('"') || text.contains('\n'))
+                text = "\"" + text.replace("\"", "\"\"") + "\"";
+
+            row.append(text);
+        }
+
+        stream << row.join(',') << "\n";
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FARM_HPP
+#define FARM_HPP
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonObject>
+#include <QList>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+
+struct FarmProfile_t
+{
+    QString Name;
+    QStringList Arguments;
+};
+
+struct FarmJob_t
+{
+    int Index;
+    QString Rom;
+    FarmProfile_t Profile;
+};
+
+struct FarmResult_t
+{
+    FarmJob_t Job;
+    QString Status;
+    int ExitCode;
+    QJsonObject Bench;
+};
+
+// Runs every ROM with every profile through rmg-bench,
+// the core can only run one game per process,
+// so each run gets its own process pinned to its own cpu
+class Farm
+{
+  public:
+    Farm(void);
+    ~Farm(void);
+
+    bool AddRoms(QString);
+    bool AddProfile(QString);
+
+    void SetBenchFile(QString);
+    void SetLogDirectory(QString);
+    void SetWorkerCount(int);
+    void SetFrames(quint64);
+    void SetTimeout(int);
+
+    bool Run(void);
+    bool WriteReport(QString);
+
+    QString GetLastError(void);
+
+  private:
+    QString error_Message;
+
+    QStringList rom_List;
+    QList<FarmProfile_t> profile_List;
+
+    QString bench_File;
+    QString log_Directory;
+    int worker_Count = 1;
+    quint64 bench_Frames = 0;
+    int bench_Timeout = 0;
+
+    QTemporaryDir output_Directory;
+    QEventLoop event_Loop;
+    QElapsedTimer run_Timer;
+
+    QList<FarmJob_t> job_Queue;
+    QList<FarmResult_t> job_Results;
+    int job_Total = 0;
+    int job_Running = 0;
+
+    bool rom_AddList(QString);
+    bool rom_AddDirectory(QString);
+
+    void worker_Start(int);
+    void worker_Finished(int, FarmJob_t, QProcess *, QString);
+
+    bool report_WriteJson(QString);
+    bool report_WriteCsv(QString);
+};
+
+#endif // FARM_HPP
@@ -0,0 +1,89 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// rmg-farm runs a set of ROMs with a set of settings profiles
+// through rmg-bench, as many at once as there are cpus,
+// and writes one JSON or CSV report with the results.
+//
+// a profile is a text file with one rmg-bench argument per line,
+// for example:
+//   --gfx=Plugin/GFX/mupen64plus-video-GLideN64.so
+//   --setting=Core/R4300Emulator=1
+//
+
+#include "Farm.hpp"
+
+#include <Config.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QThread>
+
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    Farm farm;
+
+    parser.setApplicationDescription("Runs ROMs through rmg-bench in parallel and reports the results");
+    parser.addHelpOption();
+    parser.addPositionalArgument("roms", "ROM files, directories or lists of those (.txt)", "<roms...>");
+    parser.addOption({{"p", "profile"}, "Settings profile to run every ROM with", "file"});
+    parser.addOption({{"j", "jobs"}, "Amount of ROMs to run at once", "jobs",
+                      QString::number(QThread::idealThreadCount())});
+    parser.addOption({{"f", "frames"}, "Amount of frames to run each ROM for", "frames",
+                      QString::number(APP_BENCH_FRAMES)});
+    parser.addOption({{"t", "timeout"}, "Seconds before a run counts as hung", "seconds",
+                      QString::number(APP_BENCH_TIMEOUT)});
+    parser.addOption({{"o", "output"}, "Report file, .json or .csv", "file", "report.json"});
+    parser.addOption({{"l", "logs"}, "Keep the output of every run in <directory>", "directory"});
+    parser.addOption({"bench", "rmg-bench executable to use", "file",
+                      QDir(app.applicationDirPath()).filePath(APP_BENCH_FILE)});
+    parser.process(app);
+
+    if (parser.positionalArguments().isEmpty())
+        parser.showHelp(1);
+
+    for (const QString &roms : parser.positionalArguments())
+    {
+        if (!farm.AddRoms(roms))
+        {
+            std::cerr << farm.GetLastError().toStdString() << std::endl;
+            return 1;
+        }
+    }
+
+    for (const QString &profile : parser.values("profile"))
+    {
+        if (!farm.AddProfile(profile))
+        {
+            std::cerr << farm.GetLastError().toStdString() << std::endl;
+            return 1;
+        }
+    }
+
+    farm.SetBenchFile(parser.value("bench"));
+    farm.SetLogDirectory(parser.value("logs"));
+    farm.SetWorkerCount(parser.value("jobs").toInt());
+    farm.SetFrames(parser.value("frames").toULongLong());
+    farm.SetTimeout(parser.value("timeout").toInt());
+
+    if (!farm.Run() || !farm.WriteReport(parser.value("output")))
+    {
+        std::cerr << farm.GetLastError().toStdString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// RMG-PluginProbe loads a single plugin and writes the result
+// of PluginGetVersion to stdout, this way a broken plugin
+// (or a plugin with expensive static constructors) can't take RMG down with it.
+//
+// output format (tab separated, one line):
+//   <type> <version> <api version> <capabilities> <name>
+//
+
+#include <M64P/PluginApi.hpp>
+#include <M64P/dynlib.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    m64p_dynlib_handle handle;
+    M64P::PluginApi plugin;
+    m64p_plugin_type type;
+    int version = 0, apiVersion = 0, capabilities = 0;
+    const char *name = nullptr;
+    m64p_error ret;
+
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <plugin>" << std::endl;
+        return 1;
+    }
+
+    handle = dynlib_open(argv[1]);
+    if (handle == NULL)
+    {
+        std::cerr << dynlib_strerror().toStdString() << std::endl;
+        return 1;
+    }
+
+    if (!plugin.Hook(handle))
+    {
+        std::cerr << plugin.GetLastError().toStdString() << std::endl;
+        return 1;
+    }
+
+    ret = plugin.GetVersion(&type, &version, &apiVersion, &name, &capabilities);
+    if (ret != M64ERR_SUCCESS)
+    {
+        std::cerr << "PluginGetVersion Failed: " << ret << std::endl;
+        return 1;
+    }
+
+    std::cout << (int)type << "\t" << version << "\t" << apiVersion << "\t" << capabilities << "\t"
+              << (name == nullptr ? "" : name) << std::endl;
+
+    // don't run the plugin's static destructors,
+    // we got what we came for
+    std::cout.flush();
+    _Exit(0);
+}
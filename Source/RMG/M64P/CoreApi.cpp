@@ -35,6 +35,7 @@ bool CoreApi::Hook(m64p_dynlib_handle handle)
     HOOK_FUNC(handle, Core, GetRomSettings);
     HOOK_FUNC(handle, Core, GetAPIVersions);
     HOOK_FUNC(handle, Core, ErrorMessage);
+    HOOK_FUNC_OPT(handle, , DebugGetCPUDataPtr);
 
     this->hooked = true;
     return true;
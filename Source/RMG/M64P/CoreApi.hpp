@@ -11,6 +11,7 @@
 #define M64P_COREAPI_HPP
 
 #include "api/m64p_common.h"
+#include "api/m64p_debugger.h"
 #include "api/m64p_frontend.h"
 
 #include <QString>
@@ -40,6 +41,9 @@ class CoreApi
     ptr_CoreGetAPIVersions GetAPIVersions;
     ptr_CoreErrorMessage ErrorMessage;
 
+    // optional, only used for diagnostics
+    ptr_DebugGetCPUDataPtr DebugGetCPUDataPtr;
+
   private:
     bool hooked = false;
 
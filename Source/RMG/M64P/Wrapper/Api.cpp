@@ -8,6 +8,7 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include "Api.hpp"
+#include "../../Config.hpp"
 #include "../../Globals.hpp"
 #include "../Api.hpp"
 #include "../Macros.hpp"
@@ -21,11 +22,17 @@ Api::Api(void)
 
 Api::~Api(void)
 {
+    this->Core.Shutdown();
     M64P::Core.Shutdown();
     this->core_Handle_Close();
 }
 
 bool Api::Init(QString file)
+{
+    return this->Init(file, MUPEN_CONFIG_DIR);
+}
+
+bool Api::Init(QString file, QString configDir)
 {
     this->error_Message = "Api::Init Failed: ";
 
@@ -44,7 +51,7 @@ bool Api::Init(QString file)
         return false;
     }
 
-    if (!this->Core.Init(this->core_Handle))
+    if (!this->Core.Init(this->core_Handle, configDir))
     {
         this->error_Message += this->Core.GetLastError();
         return false;
@@ -35,6 +35,7 @@ class Api : public QObject
     M64P::Wrapper::Config Config;
 
     bool Init(QString);
+    bool Init(QString, QString);
 
     QString GetLastError(void);
 
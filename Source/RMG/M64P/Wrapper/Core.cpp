@@ -14,7 +14,11 @@
 #include "../api/version.h"
 #include "Config.hpp"
 #include "Plugin.hpp"
+#include <QCoreApplication>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
 
 using namespace M64P::Wrapper;
 
@@ -24,20 +28,199 @@ Core::Core(void)
 
 Core::~Core(void)
 {
+    if (this->core_TempDir != nullptr)
+        delete this->core_TempDir;
 }
 
-void DebugCallback(void *Context, int level, const char *message)
+void Core::DebugCallback(void *Context, int level, const char *message)
 {
-    // std::cout << level << ": " << message << std::endl;
+    static const char *levels[] = {"", "Error", "Warning", "Info", "Status", "Verbose"};
+    Core *core = &g_MupenApi.Core;
+
+    // verbose messages would push
+    // out everything worth keeping
+    if (level < M64MSG_ERROR || level > M64MSG_STATUS)
+        return;
+
+    QString text = QString((const char *)Context) + " " + levels[level] + ": " + message;
+
+    QMutexLocker locker(&core->debug_Mutex);
+    core->debug_Messages.append(text);
+    while (core->debug_Messages.size() > APP_DEBUG_MESSAGES_MAX)
+        core->debug_Messages.removeFirst();
 }
 
-void StateCallback(void *Context2, m64p_core_param ParamChanged, int NewValue)
+void Core::core_StateCallback(void *Context2, m64p_core_param ParamChanged, int NewValue)
 {
-    // std::cout << ParamChanged << ": " << NewValue << std::endl;
+    Core *core = (Core *)Context2;
+
+    switch (ParamChanged)
+    {
+    case M64CORE_STATE_SAVECOMPLETE:
+        if (core->rewind_SavePending)
+        {
+            core->rewind_SaveComplete(NewValue != 0);
+            break;
+        }
+        if (core->runahead_SavePending)
+        {
+            core->runahead_SavePending = false;
+            core->runahead_SaveTime = core->runahead_Timer.nsecsElapsed();
+            if (NewValue == 0)
+                core->runahead_Reset();
+            else
+                core->runahead_SetMuted(true);
+            break;
+        }
+        if (core->state_SavePending)
+        {
+            core->state_Saved(NewValue != 0);
+
+            // doubled as the run-ahead snapshot
+            if (core->runahead_Phase > 0)
+            {
+                core->runahead_SaveTime = core->runahead_Timer.nsecsElapsed();
+                core->runahead_SetMuted(true);
+            }
+
+            // the state is captured, the core finishes
+            // writing it once the emulation has stopped
+            if (core->suspend_Pending)
+            {
+                core->suspend_Pending = false;
+                core->emulation_Stop();
+            }
+            break;
+        }
+        if (core->swap_SavePending)
+        {
+            core->swap_SavePending = false;
+            if (core->swap_InProgress)
+                core->swap_Saved(NewValue != 0);
+        }
+        break;
+    case M64CORE_STATE_LOADCOMPLETE:
+        if (core->rewind_LoadPending)
+        {
+            core->rewind_LoadPending = false;
+            break;
+        }
+        if (core->runahead_LoadPending)
+        {
+            core->runahead_LoadPending = false;
+            core->runahead_SetMuted(false);
+            if (NewValue == 0)
+                core->runahead_Reset();
+            else
+                core->runahead_Loaded();
+            break;
+        }
+        core->runahead_Reset();
+        if (core->swap_LoadPending)
+        {
+            core->swap_LoadPending = false;
+            QFile::remove(core->swap_StateFile);
+            if (core->swap_InProgress)
+                core->swap_Finish(NewValue != 0);
+            break;
+        }
+        if (core->state_LoadPending)
+        {
+            core->state_LoadPending = false;
+            core->resume_LoadPending = false;
+            g_EmuThread->on_Emulation_StateLoaded(NewValue != 0);
+        }
+        break;
+    case M64CORE_EMU_STATE:
+        // a plugin swap stops and relaunches the core,
+        // to everyone else the emulation keeps running
+        if (core->swap_Pending || core->swap_LoadRequested)
+            break;
+
+        // the lifecycle follows the core, not the thread
+        if (g_EmuThread != nullptr)
+            g_EmuThread->on_Emulation_CoreStateChanged(NewValue);
+        break;
+    default:
+        break;
+    }
 }
 
-bool Core::Init(m64p_dynlib_handle handle)
+void Core::core_FrameCallback(unsigned int FrameIndex)
 {
+    Core *core = &g_MupenApi.Core;
+    quint64 count = ++core->frame_Count;
+
+    if (count == 1)
+    {
+        core->cpu_Clock.Attach();
+
+        // the core refuses the speed limiter state
+        // before it's running, so apply it on the first frame
+        if (!core->speed_Limited)
+            core->emulation_SpeedLimited(false);
+        if (core->speed_Factor != 100 || core->runahead_Frames > 0)
+            core->SetSpeedFactor(core->speed_Factor);
+        if (core->audio_Muted || core->runahead_Frames > 0)
+            core->SetAudioMuted(core->audio_Muted);
+
+        // restore the suspended session before
+        // the boot sequence gets to show anything
+        if (core->resume_LoadPending)
+        {
+            QMutexLocker locker(&core->state_Mutex);
+            core->state_LoadRequestFile = core->resume_File;
+            core->state_LoadRequested = true;
+        }
+    }
+
+    if (count == core->frame_Limit)
+        M64P::Core.DoCommand(M64CMD_STOP, 0, NULL);
+
+    // savestates are only issued from here, one at a time,
+    // the core replaces a request it hasn't processed yet
+    // with the next one, so wait for each to complete
+
+    // restore the state saved before the plugin swap
+    // as soon as the relaunched emulation gives us a frame
+    if (core->swap_LoadRequested && !core->state_IsBusy())
+        core->swap_LoadIssue();
+
+    if (core->state_LoadRequested && !core->state_IsBusy())
+    {
+        // the loaded state is the real frame now,
+        // run-ahead starts a new cycle from it
+        core->runahead_Reset();
+        core->state_LoadIssue();
+    }
+
+    // a real frame, not a speculative one
+    if (core->swap_SaveRequested && !core->state_IsBusy() && core->runahead_Phase == 0)
+        core->swap_SaveIssue();
+
+    if (core->runahead_Frames > 0)
+    {
+        // run-ahead rolls back every frame, a rewind
+        // snapshot would be of a speculative frame,
+        // it pauses once the plugin swap has its state
+        if (!core->swap_InProgress || core->swap_SaveRequested)
+            core->runahead_Frame();
+        else
+            core->runahead_Reset();
+    }
+    else
+    {
+        if (core->state_SaveRequested && !core->state_IsBusy())
+            core->state_SaveIssue();
+
+        if (core->rewind_Enabled && !core->swap_InProgress)
+            core->rewind_Frame(count);
+    }
+}
+
+bool Core::Init(m64p_dynlib_handle handle, QString configDir)
+{
+    QByteArray configDirData = configDir.toUtf8();
     m64p_error ret;
 
     if (!M64P::Core.IsHooked())
@@ -46,8 +229,8 @@ bool Core::Init(m64p_dynlib_handle handle)
         return false;
     }
 
-    ret = M64P::Core.Startup(FRONTEND_API_VERSION, MUPEN_CONFIG_DIR, MUPEN_DATA_DIR, NULL, DebugCallback, NULL,
-                             StateCallback);
+    ret = M64P::Core.Startup(FRONTEND_API_VERSION, configDirData.constData(), MUPEN_DATA_DIR, (void *)"Core", Core::DebugCallback, this,
+                             Core::core_StateCallback);
     if (ret != M64ERR_SUCCESS)
     {
         this->error_Message = "Core::Init M64P::Core.Startup() Failed: ";
@@ -55,20 +238,51 @@ bool Core::Init(m64p_dynlib_handle handle)
         return false;
     }
 
+    ret = M64P::Core.DoCommand(M64CMD_SET_FRAME_CALLBACK, 0, (void *)Core::core_FrameCallback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        this->error_Message = "Core::Init M64P::Core.DoCommand(M64CMD_SET_FRAME_CALLBACK) Failed: ";
+        this->error_Message += M64P::Core.ErrorMessage(ret);
+        return false;
+    }
+
     this->handle = handle;
 
     return true;
 }
 
+void Core::Shutdown(void)
+{
+    this->plugin_Rsp = nullptr;
+    this->plugin_Gfx = nullptr;
+    this->plugin_Audio = nullptr;
+    this->plugin_Input = nullptr;
+
+    this->plugin_Pool_Trim(0);
+}
+
+void Core::TrimPlugins(void)
+{
+    this->plugin_Pool_Trim(0);
+}
+
 bool Core::HasPluginConfig(PluginType type)
 {
-    return this->plugin_Get(type)->HasConfig();
+    Plugin *p = this->plugin_Get(type);
+
+    if (p == nullptr)
+        return false;
+
+    return p->HasConfig();
 }
 
 bool Core::OpenPluginConfig(PluginType type)
 {
     bool ret, paused;
 
+    if (this->plugin_Get(type) == nullptr)
+        return false;
+
     paused = this->emulation_IsPaused();
 
     if (!paused)
@@ -107,6 +321,150 @@ bool Core::DisableSpeedLimiter(void)
     return this->emulation_SpeedLimited(false);
 }
 
+bool Core::IsSpeedLimited(void)
+{
+    return this->speed_Limited;
+}
+
+bool Core::SetSpeedFactor(int factor)
+{
+    m64p_error ret;
+
+    // same bounds as the core uses
+    factor = qBound(1, factor, 1000);
+
+    this->speed_Factor = factor;
+
+    // applied by core_FrameCallback once running
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
+        return true;
+
+    // run-ahead emulates every shown frame
+    // again, so the core has to run that much faster
+    factor = qMin(factor * (this->runahead_Frames + 1), 1000);
+
+    ret = M64P::Core.DoCommand(M64CMD_CORE_STATE_SET, M64CORE_SPEED_FACTOR, &factor);
+    if (ret != M64ERR_SUCCESS)
+    {
+        this->error_Message = "Core::SetSpeedFactor: M64P::Core.DoCommand(M64CMD_CORE_STATE_SET) Failed: ";
+        this->error_Message += M64P::Core.ErrorMessage(ret);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+int Core::GetSpeedFactor(void)
+{
+    return this->speed_Factor;
+}
+
+bool Core::SetAudioMuted(bool muted)
+{
+    m64p_error ret;
+
+    // run-ahead mutes its speculative frames on its own
+    int value = (muted || this->runahead_Muted) ? 1 : 0;
+
+    this->audio_Muted = muted;
+
+    // applied by core_FrameCallback once running
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
+        return true;
+
+    ret = M64P::Core.DoCommand(M64CMD_CORE_STATE_SET, M64CORE_AUDIO_MUTE, &value);
+    if (ret != M64ERR_SUCCESS)
+    {
+        this->error_Message = "Core::SetAudioMuted: M64P::Core.DoCommand(M64CMD_CORE_STATE_SET) Failed: ";
+        this->error_Message += M64P::Core.ErrorMessage(ret);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+quint64 Core::GetFrameCount(void)
+{
+    return this->frame_Count;
+}
+
+void Core::SetFrameLimit(quint64 frames)
+{
+    this->frame_Limit = frames;
+}
+
+bool Core::GetProgramCounter(quint32 *pc)
+{
+    quint32 *ptr;
+
+    if (M64P::Core.DebugGetCPUDataPtr == nullptr)
+    {
+        this->error_Message = "Core::GetProgramCounter: DebugGetCPUDataPtr isn't exported by the core";
+        return false;
+    }
+
+    ptr = (quint32 *)M64P::Core.DebugGetCPUDataPtr(M64P_CPU_PC);
+    if (ptr == nullptr)
+    {
+        this->error_Message = "Core::GetProgramCounter: M64P::Core.DebugGetCPUDataPtr(M64P_CPU_PC) Failed";
+        return false;
+    }
+
+    *pc = *ptr;
+    return true;
+}
+
+QStringList Core::GetDebugMessages(void)
+{
+    QMutexLocker locker(&this->debug_Mutex);
+    return this->debug_Messages;
+}
+
+qint64 Core::GetCpuTime(void)
+{
+    return this->cpu_Clock.GetTime();
+}
+
+void Core::SetRewind(bool enabled, int interval, qint64 budget)
+{
+    this->rewind_Enabled = enabled;
+    this->rewind_Interval = qMax(1, interval);
+    this->rewind_Buffer.SetBudget(budget);
+}
+
+void Core::SetRewindActive(bool active)
+{
+    this->rewind_Active = active;
+}
+
+int Core::GetRewindInterval(void)
+{
+    return this->rewind_Interval;
+}
+
+Utilities::RewindBuffer *Core::GetRewindBuffer(void)
+{
+    return &this->rewind_Buffer;
+}
+
+int Core::GetRunAheadFrames(void)
+{
+    return this->runahead_Frames;
+}
+
+double Core::GetRunAheadStateTime(void)
+{
+    return this->runahead_StateTime / 1000000.0;
+}
+
+bool Core::IsFrameHidden(void)
+{
+    return this->runahead_Hidden || this->resume_LoadPending || this->present_Skipped;
+}
+
+void Core::SetPresentationSkipped(bool skipped)
+{
+    this->present_Skipped = skipped;
+}
+
 QList<Plugin_t> Core::GetPlugins(PluginType type)
 {
     QList<Plugin_t> plugins;
@@ -158,22 +516,97 @@ M64P::Wrapper::Plugin *Core::plugin_Get(PluginType type)
     switch (type)
     {
     case PluginType::Gfx:
-        return &this->plugin_Gfx;
+        return this->plugin_Gfx;
     case PluginType::Rsp:
-        return &this->plugin_Rsp;
+        return this->plugin_Rsp;
     case PluginType::Audio:
-        return &this->plugin_Audio;
+        return this->plugin_Audio;
     case PluginType::Input:
-        return &this->plugin_Input;
+        return this->plugin_Input;
     default:
         return nullptr;
     }
 }
 
+bool Core::plugin_IsActive(Plugin *p)
+{
+    return p == this->plugin_Gfx || p == this->plugin_Rsp || p == this->plugin_Audio || p == this->plugin_Input;
+}
+
+bool Core::plugin_Pool_Get(QString file, Plugin **plugin)
+{
+    Plugin *p;
+
+    // re-use warm plugin when we have one
+    if (this->plugin_Pool.contains(file))
+    {
+        this->plugin_Pool_Usage.removeAll(file);
+        this->plugin_Pool_Usage.append(file);
+        *plugin = this->plugin_Pool.value(file);
+        return true;
+    }
+
+    p = new Plugin();
+
+    if (!p->Init(file, this->handle))
+    {
+        this->error_Message = "Core::plugin_Pool_Get p->Init() Failed: ";
+        this->error_Message += p->GetLastError();
+        delete p;
+        return false;
+    }
+
+    if (!p->Startup())
+    {
+        this->error_Message = "Core::plugin_Pool_Get p->Startup() Failed: ";
+        this->error_Message += p->GetLastError();
+        delete p;
+        return false;
+    }
+
+    this->plugin_Pool.insert(file, p);
+    this->plugin_Pool_Usage.append(file);
+
+    this->plugin_Pool_Trim(APP_PLUGINPOOL_MAX);
+
+    *plugin = p;
+    return true;
+}
+
+void Core::plugin_Pool_Trim(int max)
+{
+    QStringList usage = this->plugin_Pool_Usage;
+    Plugin *p;
+
+    // shutdown least recently used plugins first,
+    // skipping the ones which are currently in use
+    for (const QString &file : usage)
+    {
+        if (this->plugin_Pool.size() <= max)
+            break;
+
+        p = this->plugin_Pool.value(file);
+        if (this->plugin_IsActive(p))
+            continue;
+
+        p->Shutdown();
+        delete p;
+
+        this->plugin_Pool.remove(file);
+        this->plugin_Pool_Usage.removeAll(file);
+    }
+}
+
 bool Core::plugin_Attach(Plugin *p)
 {
     m64p_error ret;
 
+    if (p == nullptr)
+    {
+        this->error_Message = "Core::plugin_Attach Failed: no plugin loaded";
+        return false;
+    }
+
     ret = M64P::Core.AttachPlugin(p->GetType(), p->GetHandle());
 
     if (ret != M64ERR_SUCCESS)
@@ -187,8 +620,8 @@ bool Core::plugin_Attach(Plugin *p)
 
 bool Core::plugins_Attach(void)
 {
-    return this->plugin_Attach(&this->plugin_Gfx) && this->plugin_Attach(&this->plugin_Audio) &&
-           this->plugin_Attach(&this->plugin_Input) && this->plugin_Attach(&this->plugin_Rsp);
+    return this->plugin_Attach(this->plugin_Gfx) && this->plugin_Attach(this->plugin_Audio) &&
+           this->plugin_Attach(this->plugin_Input) && this->plugin_Attach(this->plugin_Rsp);
 }
 
 bool Core::plugins_Detach(void)
@@ -218,7 +651,7 @@ bool Core::plugin_LoadTodo(void)
 
 bool Core::SetPlugin(Plugin_t plugin)
 {
-    bool ret;
+    Plugin *p;
 
     // don't apply plugins when emulation is running
     if (this->IsEmulationRunning() || this->isEmulationPaused())
@@ -227,43 +660,285 @@ bool Core::SetPlugin(Plugin_t plugin)
         return true;
     }
 
-    Plugin *p = this->plugin_Get(plugin.Type);
+    // plugins are kept alive in the pool,
+    // so switching between them doesn't require
+    // a shutdown and re-init every time
+    if (!this->plugin_Pool_Get(plugin.FileName, &p))
+        return false;
 
-    if (p->HasInit())
+    switch (p->GetPlugin_t().Type)
     {
-        ret = p->Shutdown();
-        if (!ret)
-        {
-            this->error_Message = "Core::SetPlugin p->Shutdown() Failed: ";
-            this->error_Message += p->GetLastError();
-            return false;
-        }
+    case PluginType::Gfx:
+        this->plugin_Gfx = p;
+        break;
+    case PluginType::Rsp:
+        this->plugin_Rsp = p;
+        break;
+    case PluginType::Audio:
+        this->plugin_Audio = p;
+        break;
+    case PluginType::Input:
+        this->plugin_Input = p;
+        break;
+    default:
+        this->error_Message = "Core::SetPlugin Failed: invalid plugin type";
+        return false;
     }
 
-    ret = p->Init(plugin.FileName, this->handle);
-    if (!ret)
+    return true;
+}
+
+bool Core::SwapPlugin(Plugin_t plugin)
+{
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
+        return this->SetPlugin(plugin);
+
+    if (this->swap_InProgress)
     {
-        this->error_Message = "Core::SetPlugin p->Init() Failed: ";
-        this->error_Message += p->GetLastError();
+        this->error_Message = "Core::SwapPlugin Failed: plugin swap already in progress";
         return false;
     }
 
-    ret = p->Startup();
-    if (!ret)
-    {
-        this->error_Message = "Core::SetPlugin p->Startup() Failed: ";
-        this->error_Message += p->GetLastError();
+    // savestates are only processed while
+    // the emulation is running
+    if (this->emulation_IsPaused() && !this->ResumeEmulation())
         return false;
+
+    // the swap only lasts for the current session,
+    // so restore the current plugin afterwards
+    bool restoreQueued = false;
+    Plugin_t currentPlugin;
+
+    for (const Plugin_t &p : this->plugin_Todo)
+    {
+        if (p.Type == plugin.Type)
+            restoreQueued = true;
     }
 
+    if (!restoreQueued && this->GetCurrentPlugin(plugin.Type, &currentPlugin))
+        this->plugin_Todo.append(currentPlugin);
+
+    this->swap_Timer.start();
+    this->swap_Plugin = plugin;
+    this->swap_StateFile = this->core_TempFile("RMG_PluginSwap.st");
+
+    // the state is saved by core_FrameCallback,
+    // swap_Saved() takes it from there
+    this->swap_InProgress = true;
+    this->swap_SaveRequested = true;
     return true;
 }
 
+int Core::GetLastPluginSwapTime(void)
+{
+    return this->swap_Time;
+}
+
+void Core::rewind_Frame(quint64 count)
+{
+    m64p_error ret;
+    QByteArray state;
+    QFile file(this->rewind_File);
+
+    // the user's requests go first
+    if (this->state_IsBusy() || this->state_SaveRequested || this->state_LoadRequested)
+        return;
+
+    // step back one snapshot every frame while rewinding,
+    // the core loads it at the next VI
+    if (this->rewind_Active)
+    {
+        if (!this->rewind_Buffer.Rewind(&state))
+            return;
+
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(state) != state.size())
+            return;
+        file.close();
+
+        this->rewind_LoadPending = true;
+        if (!this->state_LoadFromFile(this->rewind_File))
+            this->rewind_LoadPending = false;
+        return;
+    }
+
+    if (count % this->rewind_Interval != 0)
+        return;
+
+    // uncompressed, the delta encoding is
+    // what keeps the buffer small
+    this->rewind_SavePending = true;
+    ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 3, (void *)this->rewind_File.toStdString().c_str());
+    if (ret != M64ERR_SUCCESS)
+        this->rewind_SavePending = false;
+}
+
+void Core::rewind_SaveComplete(bool success)
+{
+    QFile file(this->rewind_File);
+
+    this->rewind_SavePending = false;
+
+    if (!success || !file.open(QIODevice::ReadOnly))
+        return;
+
+    this->rewind_Buffer.Push(file.readAll());
+}
+
+void Core::runahead_Frame(void)
+{
+    m64p_error ret;
+
+    // a save or load is applied at the next VI,
+    // wait for it before moving on
+    if (this->state_IsBusy())
+        return;
+
+    // the next frame is the real one, continuing from the
+    // state of the previous cycle with the current input,
+    // save what it leaves behind and run ahead from there
+    if (this->runahead_Phase == 0)
+    {
+        this->runahead_Hidden = true;
+        this->runahead_Phase = 1;
+        this->runahead_Timer.start();
+
+        // a requested savestate is of the real frame too,
+        // so it doubles as the snapshot to roll back to
+        if (this->state_SaveRequested)
+        {
+            this->state_SaveIssue();
+            this->runahead_StateFile = this->state_IssuedFile;
+            return;
+        }
+
+        // m64p, PJ64 states leave out part of the
+        // machine, every rollback would drift a bit
+        this->runahead_StateFile = this->runahead_File;
+        this->runahead_SavePending = true;
+        ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void *)this->runahead_File.toStdString().c_str());
+        if (ret != M64ERR_SUCCESS)
+            this->runahead_Reset();
+        return;
+    }
+
+    // speculative frames, only the last one is shown,
+    // then roll back to the real frame
+    if (this->runahead_Phase < this->runahead_Frames)
+    {
+        this->runahead_Phase++;
+        return;
+    }
+
+    this->runahead_Hidden = false;
+    this->runahead_Phase = 0;
+    this->runahead_Timer.start();
+
+    this->runahead_LoadPending = true;
+    if (!this->state_LoadFromFile(this->runahead_StateFile))
+        this->runahead_Reset();
+}
+
+void Core::runahead_Reset(void)
+{
+    this->runahead_Phase = 0;
+    this->runahead_Hidden = false;
+    this->runahead_SavePending = false;
+    this->runahead_LoadPending = false;
+    this->runahead_SetMuted(false);
+}
+
+void Core::runahead_Loaded(void)
+{
+    qint64 time = this->runahead_SaveTime + this->runahead_Timer.nsecsElapsed();
+
+    // from issuing to completion, which includes the
+    // core compressing, writing and reading it back,
+    // smoothed so the stats show something readable
+    if (this->runahead_StateTime == 0)
+        this->runahead_StateTime = time;
+    else
+        this->runahead_StateTime = (this->runahead_StateTime * 7 + time) / 8;
+}
+
+void Core::runahead_SetMuted(bool muted)
+{
+    int value;
+
+    if (this->runahead_Muted == muted)
+        return;
+
+    // once the snapshot is saved, everything up to the
+    // rollback is speculative, only the real frames get
+    // to play their audio, or it'd play N+1 times over
+    this->runahead_Muted = muted;
+    value = (muted || this->audio_Muted) ? 1 : 0;
+    M64P::Core.DoCommand(M64CMD_CORE_STATE_SET, M64CORE_AUDIO_MUTE, &value);
+}
+
+void Core::swap_SaveIssue(void)
+{
+    this->swap_SaveRequested = false;
+    this->swap_SavePending = true;
+
+    if (!this->state_SaveToFile(this->swap_StateFile))
+    {
+        this->swap_SavePending = false;
+        this->swap_Finish(false);
+    }
+}
+
+void Core::swap_Saved(bool success)
+{
+    if (!success)
+    {
+        this->error_Message = "Core::swap_Saved: saving state failed";
+        this->swap_Finish(false);
+        return;
+    }
+
+    // the emulation thread picks up the swap
+    // once M64CMD_EXECUTE returns
+    this->swap_Pending = true;
+    if (!this->emulation_Stop())
+    {
+        this->swap_Pending = false;
+        this->swap_Finish(false);
+    }
+}
+
+void Core::swap_LoadIssue(void)
+{
+    this->swap_LoadRequested = false;
+    this->swap_LoadPending = true;
+
+    if (!this->state_LoadFromFile(this->swap_StateFile))
+    {
+        this->swap_LoadPending = false;
+        if (this->swap_InProgress)
+            this->swap_Finish(false);
+    }
+}
+
+void Core::swap_Finish(bool success)
+{
+    this->swap_Time = this->swap_Timer.elapsed();
+    this->swap_InProgress = false;
+
+    // still needed to continue where the game was
+    if (!this->swap_LoadRequested && !this->swap_LoadPending)
+        QFile::remove(this->swap_StateFile);
+
+    g_Logger.AddText("Core::swap_Finish: plugin swap " + QString(success ? "finished" : "failed") + " in " +
+                     QString::number(this->swap_Time) + "ms");
+
+    g_EmuThread->on_Emulation_PluginSwapped(success, this->swap_Time);
+}
+
 bool Core::GetCurrentPlugin(PluginType type, Plugin_t *plugin_t)
 {
     Plugin *p = this->plugin_Get(type);
 
-    if (!p->HasInit())
+    if (p == nullptr || !p->HasInit())
         return false;
 
     *plugin_t = p->GetPlugin_t();
@@ -339,10 +1014,60 @@ bool Core::GetDefaultRomInfo(RomInfo_t *romInfo)
     return true;
 }
 
+double Core::GetRomViRate(RomInfo_t *info)
+{
+    // same PAL country codes the core uses
+    switch (info->Header.Country_code & 0xFF)
+    {
+    case 0x44:
+    case 0x46:
+    case 0x49:
+    case 0x50:
+    case 0x53:
+    case 0x55:
+    case 0x58:
+    case 0x59:
+        return 50.0;
+    default:
+        return 60.0;
+    }
+}
+
 bool Core::LaunchEmulation(QString file)
 {
     m64p_error ret;
 
+    this->frame_Count = 0;
+
+    this->rewind_Buffer.Clear();
+    this->rewind_SavePending = false;
+    this->rewind_LoadPending = false;
+    this->rewind_File = this->core_TempFile("RMG_Rewind.st");
+
+    this->runahead_Frames = 0;
+    this->runahead_StateTime = 0;
+    this->runahead_Reset();
+    this->runahead_File = this->core_TempFile("RMG_RunAhead.st");
+
+    this->state_Writer.SetWriteCallback([](QString file, bool success) {
+        if (g_EmuThread != nullptr)
+            g_EmuThread->on_Emulation_StateSaved(success, file);
+    });
+    this->state_SaveRequested = false;
+    this->state_SavePending = false;
+    this->state_LoadRequested = false;
+    this->state_LoadPending = false;
+    this->state_LoadRequestFile.clear();
+    this->state_CapturedFile.clear();
+    this->state_CaptureFile = this->core_TempFile("RMG_Capture.st");
+
+    this->swap_InProgress = false;
+    this->swap_SaveRequested = false;
+    this->swap_SavePending = false;
+    this->swap_Pending = false;
+    this->swap_LoadRequested = false;
+    this->swap_LoadPending = false;
+
     if (!this->plugin_LoadTodo())
         return false;
 
@@ -358,6 +1083,11 @@ bool Core::LaunchEmulation(QString file)
     if (!this->core_ApplyOverlay())
         return false;
 
+    // how many frames are worth running ahead
+    // depends on how much lag the game has built in
+    this->runahead_Frames = g_Settings.GetIntValue(SettingsID::Game_RunAheadFrames, this->rom_Info.Settings.MD5);
+    this->runahead_Frames = qBound(0, this->runahead_Frames, APP_RUNAHEAD_MAX_FRAMES);
+
     if (!this->plugins_Attach())
         return false;
 
@@ -365,6 +1095,32 @@ bool Core::LaunchEmulation(QString file)
 
     this->plugins_Detach();
 
+    // live plugin swap requested,
+    // swap the plugin and relaunch,
+    // the state gets restored in core_FrameCallback
+    while (ret == M64ERR_SUCCESS && this->swap_Pending)
+    {
+        this->swap_Pending = false;
+        this->swap_LoadRequested = true;
+
+        // the game goes on with the plugin it had
+        if (!this->SetPlugin(this->swap_Plugin))
+            this->swap_Finish(false);
+
+        if (!this->plugins_Attach())
+        {
+            this->swap_LoadRequested = false;
+            if (this->swap_InProgress)
+                this->swap_Finish(false);
+            this->rom_Close();
+            return false;
+        }
+
+        ret = M64P::Core.DoCommand(M64CMD_EXECUTE, 0, NULL);
+
+        this->plugins_Detach();
+    }
+
     if (ret != M64ERR_SUCCESS)
     {
         this->rom_Close();
@@ -383,6 +1139,17 @@ bool Core::LaunchEmulation(QString file)
 }
 
 bool Core::StopEmulation(void)
+{
+    // a stop request cancels any pending plugin swap
+    this->swap_InProgress = false;
+    this->swap_SaveRequested = false;
+    this->swap_Pending = false;
+    this->swap_LoadRequested = false;
+
+    return this->emulation_Stop();
+}
+
+bool Core::emulation_Stop(void)
 {
     m64p_error ret;
 
@@ -392,7 +1159,7 @@ bool Core::StopEmulation(void)
     ret = M64P::Core.DoCommand(M64CMD_STOP, 0, NULL);
     if (ret != M64ERR_SUCCESS)
     {
-        this->error_Message = "Core::StopEmulation M64P::Core.DoCommand(M64CMD_STOP) Failed: ";
+        this->error_Message = "Core::emulation_Stop M64P::Core.DoCommand(M64CMD_STOP) Failed: ";
         this->error_Message += M64P::Core.ErrorMessage(ret);
         return false;
     }
@@ -478,61 +1245,277 @@ bool Core::SetSaveSlot(int slot)
     {
         this->error_Message = "Core::SetSaveSlot M64P::Core.DoCommand(M64CMD_STATE_SET_SLOT) Failed: ";
         this->error_Message += M64P::Core.ErrorMessage(ret);
+        return false;
     }
 
-    return ret == M64ERR_SUCCESS;
+    this->state_Slot = slot;
+    return true;
+}
+
+int Core::GetSaveSlot(void)
+{
+    return this->state_Slot;
+}
+
+QString Core::GetSaveStateFile(int slot)
+{
+    QString dir = g_Settings.GetStringValue(SettingsID::Core_SaveStatePath);
+
+    // same name and format the core uses for its
+    // slots, so either side can load the other's states
+    return QDir(dir).filePath(QString(this->rom_Info.Settings.goodname) + ".st" + QString::number(slot));
 }
 
 bool Core::SaveStateAsFile(QString file)
 {
-    m64p_error ret;
+    return this->state_Save(file);
+}
 
-    ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void *)file.toStdString().c_str());
-    if (ret != M64ERR_SUCCESS)
+bool Core::LoadStateFromFile(QString file)
+{
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
     {
-        this->error_Message = "Core::SaveStateAsFile: M64P::Core.DoCommand(M64CMD_STATE_SAVE) Failed: ";
-        this->error_Message += M64P::Core.ErrorMessage(ret);
+        this->error_Message = "Core::LoadStateFromFile Failed: emulation isn't running";
+        return false;
     }
 
-    return ret == M64ERR_SUCCESS;
+    // issued by core_FrameCallback, a newer
+    // request replaces one that hasn't been
+    QMutexLocker locker(&this->state_Mutex);
+    this->state_LoadRequestFile = file;
+    this->state_LoadRequested = true;
+    return true;
 }
 
-bool Core::LoadStateFromFile(QString file)
+bool Core::SaveState(void)
+{
+    return this->state_Save(this->GetSaveStateFile(this->state_Slot));
+}
+
+bool Core::LoadState(void)
+{
+    return this->LoadStateFromFile(this->GetSaveStateFile(this->state_Slot));
+}
+
+bool Core::CaptureState(void)
+{
+    return this->state_Save(QString());
+}
+
+bool Core::SaveCapturedState(QString file)
+{
+    QMutexLocker locker(&this->state_Mutex);
+
+    // still being captured, it'll be written once it is
+    if (this->state_SaveRequested || this->state_SavePending)
+    {
+        this->state_SaveFile = file;
+        return true;
+    }
+
+    if (this->state_CapturedFile.isEmpty())
+    {
+        this->error_Message = "Core::SaveCapturedState Failed: no state has been captured";
+        return false;
+    }
+
+    this->state_Writer.Write(file, this->state_CapturedFile, this->state_CapturedScreen);
+    this->state_CapturedFile.clear();
+    this->state_CapturedScreen = QImage();
+    return true;
+}
+
+void Core::WaitForSaveStates(void)
+{
+    this->state_Writer.Wait();
+}
+
+bool Core::SuspendEmulation(QString file)
+{
+    if (!this->state_Save(file))
+        return false;
+
+    // stopped by core_StateCallback once the
+    // state has been saved, which needs frames
+    this->suspend_Pending = true;
+    if (this->emulation_IsPaused())
+        this->ResumeEmulation();
+
+    return true;
+}
+
+void Core::SetResumeState(QString file)
+{
+    this->resume_File = file;
+    this->resume_LoadPending = !file.isEmpty();
+}
+
+bool Core::state_Save(QString file)
+{
+    QMutexLocker locker(&this->state_Mutex);
+
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
+    {
+        this->error_Message = "Core::state_Save Failed: emulation isn't running";
+        return false;
+    }
+
+    if (this->state_SaveRequested || this->state_SavePending)
+    {
+        this->error_Message = "Core::state_Save Failed: a savestate is still being saved";
+        return false;
+    }
+
+    // issued by core_FrameCallback
+    this->state_SaveFile = file;
+    this->state_CapturedFile.clear();
+    this->state_CapturedScreen = QImage();
+    this->state_SaveRequested = true;
+    return true;
+}
+
+void Core::state_SaveIssue(void)
 {
     m64p_error ret;
 
-    ret = M64P::Core.DoCommand(M64CMD_STATE_LOAD, 0, (void *)file.toStdString().c_str());
+    QMutexLocker locker(&this->state_Mutex);
+    this->state_SaveRequested = false;
+    this->state_SavePending = true;
+
+    // a capture waits in a temporary
+    // file until it gets a name
+    this->state_IssuedFile = this->state_SaveFile;
+    if (this->state_IssuedFile.isEmpty())
+        this->state_IssuedFile = this->state_CaptureFile;
+    locker.unlock();
+
+    // the frame the state is saved at,
+    // scaled and encoded along with the state
+    this->state_Screen = this->state_ReadScreen();
+
+    // the core won't create the directory itself
+    QDir().mkpath(QFileInfo(this->state_IssuedFile).absolutePath());
+
+    // m64p, like the core's own slots, the core compresses
+    // and writes it on its savestate thread, and a load
+    // waits for that to be done
+    ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void *)this->state_IssuedFile.toStdString().c_str());
     if (ret != M64ERR_SUCCESS)
+        this->state_Saved(false);
+}
+
+void Core::state_Saved(bool success)
+{
+    QString saveFile;
+    QImage screen;
+
+    QMutexLocker locker(&this->state_Mutex);
+
+    this->state_SavePending = false;
+    saveFile = this->state_SaveFile;
+    screen = this->state_Screen;
+    this->state_Screen = QImage();
+
+    if (!success)
     {
-        this->error_Message = "Core::SaveStateAsFile: M64P::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
-        this->error_Message += M64P::Core.ErrorMessage(ret);
+        g_EmuThread->on_Emulation_StateSaved(false, saveFile);
+        return;
     }
 
-    return ret == M64ERR_SUCCESS;
+    if (saveFile.isEmpty())
+    {
+        this->state_CapturedFile = this->state_IssuedFile;
+        this->state_CapturedScreen = screen;
+        return;
+    }
+
+    // named while it was being captured
+    if (saveFile != this->state_IssuedFile)
+    {
+        this->state_Writer.Write(saveFile, this->state_IssuedFile, screen);
+        return;
+    }
+
+    this->state_Writer.Write(saveFile, QString(), screen);
 }
 
-bool Core::SaveState(void)
+void Core::state_LoadIssue(void)
+{
+    QMutexLocker locker(&this->state_Mutex);
+    QString file = this->state_LoadRequestFile;
+
+    this->state_LoadRequested = false;
+    this->state_LoadPending = true;
+    locker.unlock();
+
+    if (!this->state_LoadFromFile(file))
+    {
+        g_Logger.AddText("Core::state_LoadIssue: " + this->error_Message);
+        this->state_LoadFailed();
+    }
+}
+
+void Core::state_LoadFailed(void)
+{
+    this->state_LoadPending = false;
+    this->resume_LoadPending = false;
+    g_EmuThread->on_Emulation_StateLoaded(false);
+}
+
+bool Core::state_IsBusy(void)
+{
+    return this->state_SavePending || this->state_LoadPending || this->rewind_SavePending ||
+           this->rewind_LoadPending || this->runahead_SavePending || this->runahead_LoadPending ||
+           this->swap_SavePending || this->swap_LoadPending;
+}
+
+QImage Core::state_ReadScreen(void)
+{
+    m64p_error ret;
+    int videoSize = 0;
+    int width, height;
+
+    ret = M64P::Core.DoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_VIDEO_SIZE, &videoSize);
+    if (ret != M64ERR_SUCCESS)
+        return QImage();
+
+    width = (videoSize >> 16) & 0xFFFF;
+    height = videoSize & 0xFFFF;
+    if (width <= 0 || height <= 0)
+        return QImage();
+
+    // the core writes tightly packed RGB rows,
+    // QImage pads them to 4 bytes, so copy it over
+    QByteArray pixels(width * height * 3, 0);
+    ret = M64P::Core.DoCommand(M64CMD_READ_SCREEN, 1, pixels.data());
+    if (ret != M64ERR_SUCCESS)
+        return QImage();
+
+    return QImage((const uchar *)pixels.constData(), width, height, width * 3, QImage::Format_RGB888).copy();
+}
+
+bool Core::state_SaveToFile(QString file)
 {
     m64p_error ret;
 
-    ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 0, NULL);
+    ret = M64P::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void *)file.toStdString().c_str());
     if (ret != M64ERR_SUCCESS)
     {
-        this->error_Message = "Core::SaveState: M64P::Core.DoCommand(M64CMD_STATE_SAVE) Failed: ";
+        this->error_Message = "Core::state_SaveToFile: M64P::Core.DoCommand(M64CMD_STATE_SAVE) Failed: ";
         this->error_Message += M64P::Core.ErrorMessage(ret);
     }
 
     return ret == M64ERR_SUCCESS;
 }
 
-bool Core::LoadState(void)
+bool Core::state_LoadFromFile(QString file)
 {
     m64p_error ret;
 
-    ret = M64P::Core.DoCommand(M64CMD_STATE_LOAD, 0, NULL);
+    ret = M64P::Core.DoCommand(M64CMD_STATE_LOAD, 0, (void *)file.toStdString().c_str());
     if (ret != M64ERR_SUCCESS)
     {
-        this->error_Message = "Core::LoadState: M64P::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
+        this->error_Message = "Core::state_LoadFromFile: M64P::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
         this->error_Message += M64P::Core.ErrorMessage(ret);
     }
 
@@ -762,6 +1745,28 @@ bool Core::rom_ApplyOverlay(void)
     return ret2 == M64ERR_SUCCESS;
 }
 
+QString Core::core_TempFile(QString name)
+{
+    QString dir;
+
+    // keep round trips through the core's savestate
+    // code off the disk when possible, in a directory
+    // of our own, so other instances don't overwrite them
+    if (this->core_TempDir == nullptr)
+    {
+        dir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+        if (dir.isEmpty())
+            dir = QDir::tempPath();
+
+        this->core_TempDir = new QTemporaryDir(QDir(dir).filePath("RMG-XXXXXX"));
+    }
+
+    if (!this->core_TempDir->isValid())
+        return QDir::temp().filePath("RMG-" + QString::number(QCoreApplication::applicationPid()) + "-" + name);
+
+    return this->core_TempDir->filePath(name);
+}
+
 bool Core::core_ApplyOverlay(void)
 {
     bool ret;
@@ -853,6 +1858,12 @@ bool Core::emulation_SpeedLimited(bool enabled)
 
     int value = enabled ? 1 : 0;
 
+    this->speed_Limited = enabled;
+
+    // applied by core_FrameCallback once running
+    if (!this->emulation_IsRunning() && !this->emulation_IsPaused())
+        return true;
+
     ret = M64P::Core.DoCommand(M64CMD_CORE_STATE_SET, M64CORE_SPEED_LIMITER, &value);
     if (ret != M64ERR_SUCCESS)
     {
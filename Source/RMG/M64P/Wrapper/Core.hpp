@@ -10,11 +10,22 @@
 #ifndef M64P_WRAPPER_CORE_HPP
 #define M64P_WRAPPER_CORE_HPP
 
+#include "../../Utilities/RewindBuffer.hpp"
+#include "../../Utilities/SaveStateWriter.hpp"
+#include "../../Utilities/ThreadClock.hpp"
 #include "Plugin.hpp"
 #include "Types.hpp"
 
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
 #include <QList>
+#include <QMap>
 #include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include <atomic>
 
 namespace M64P
 {
@@ -26,18 +37,24 @@ class Core
     Core(void);
     ~Core(void);
 
-    bool Init(m64p_dynlib_handle);
+    bool Init(m64p_dynlib_handle, QString);
+    void Shutdown(void);
+    // shuts down the pooled plugins nothing uses
+    void TrimPlugins(void);
 
     bool HasPluginConfig(PluginType);
     bool OpenPluginConfig(PluginType);
 
     QList<Plugin_t> GetPlugins(PluginType);
     bool SetPlugin(Plugin_t);
+    bool SwapPlugin(Plugin_t);
     bool GetCurrentPlugin(PluginType, Plugin_t *);
+    int GetLastPluginSwapTime(void);
 
     bool GetRomInfo(QString, RomInfo_t *, bool);
     bool GetRomInfo(RomInfo_t *);
     bool GetDefaultRomInfo(RomInfo_t *);
+    double GetRomViRate(RomInfo_t *);
 
     bool LaunchEmulation(QString);
     bool StopEmulation(void);
@@ -52,17 +69,65 @@ class Core
 
     bool EnableSpeedLimiter(void);
     bool DisableSpeedLimiter(void);
+    bool IsSpeedLimited(void);
+
+    bool SetSpeedFactor(int);
+    int GetSpeedFactor(void);
+
+    bool SetAudioMuted(bool);
+
+    void SetRewind(bool, int, qint64);
+    void SetRewindActive(bool);
+    int GetRewindInterval(void);
+    Utilities::RewindBuffer *GetRewindBuffer(void);
+
+    // speculative frames emulated per shown frame, per game
+    int GetRunAheadFrames(void);
+    // what saving and loading the state of a cycle costs, in ms
+    double GetRunAheadStateTime(void);
+    bool IsFrameHidden(void);
+
+    // keeps emulating, but nothing gets presented
+    void SetPresentationSkipped(bool);
+
+    quint64 GetFrameCount(void);
+    void SetFrameLimit(quint64);
+    qint64 GetCpuTime(void);
+
+    // for hang reports, read while the
+    // emulation thread might be stuck
+    bool GetProgramCounter(quint32 *);
+    QStringList GetDebugMessages(void);
+
+    // shared with the plugins, the context is their name
+    static void DebugCallback(void *, int, const char *);
 
     bool PressGameSharkButton(void);
 
     bool SetSaveSlot(int);
+    int GetSaveSlot(void);
+    QString GetSaveStateFile(int);
 
+    // saving returns right away, the state gets captured
+    // at the next frame and written in the background,
+    // loading gets issued at the next frame
     bool SaveStateAsFile(QString);
     bool LoadStateFromFile(QString);
 
     bool SaveState(void);
     bool LoadState(void);
 
+    // capture now, decide where to write it later
+    bool CaptureState(void);
+    bool SaveCapturedState(QString);
+
+    void WaitForSaveStates(void);
+
+    // saves the state, then stops emulation
+    bool SuspendEmulation(QString);
+    // loaded on the first frame of the next launch
+    void SetResumeState(QString);
+
     bool SetKeyDown(int, int);
     bool SetKeyUp(int, int);
 
@@ -76,17 +141,110 @@ class Core
     m64p_dynlib_handle handle;
 
     QList<Plugin_t> plugin_Todo;
-    M64P::Wrapper::Plugin plugin_Rsp;
-    M64P::Wrapper::Plugin plugin_Gfx;
-    M64P::Wrapper::Plugin plugin_Audio;
-    M64P::Wrapper::Plugin plugin_Input;
+    M64P::Wrapper::Plugin *plugin_Rsp = nullptr;
+    M64P::Wrapper::Plugin *plugin_Gfx = nullptr;
+    M64P::Wrapper::Plugin *plugin_Audio = nullptr;
+    M64P::Wrapper::Plugin *plugin_Input = nullptr;
+
+    QMap<QString, M64P::Wrapper::Plugin *> plugin_Pool;
+    QStringList plugin_Pool_Usage;
 
     M64P::Wrapper::Plugin *plugin_Get(PluginType);
+    bool plugin_IsActive(Plugin *);
+    bool plugin_Pool_Get(QString, Plugin **);
+    void plugin_Pool_Trim(int);
     bool plugin_Attach(Plugin *);
     bool plugins_Attach(void);
     bool plugins_Detach(void);
     bool plugin_LoadTodo(void);
 
+    std::atomic<bool> swap_InProgress{false};
+    std::atomic<bool> swap_SaveRequested{false};
+    std::atomic<bool> swap_SavePending{false};
+    std::atomic<bool> swap_Pending{false};
+    std::atomic<bool> swap_LoadRequested{false};
+    std::atomic<bool> swap_LoadPending{false};
+    Plugin_t swap_Plugin;
+    QString swap_StateFile;
+    QElapsedTimer swap_Timer;
+    int swap_Time = -1;
+
+    void swap_SaveIssue(void);
+    void swap_Saved(bool);
+    void swap_LoadIssue(void);
+    void swap_Finish(bool);
+
+    Utilities::SaveStateWriter state_Writer;
+    QMutex state_Mutex;
+    std::atomic<bool> state_SaveRequested{false};
+    std::atomic<bool> state_SavePending{false};
+    std::atomic<bool> state_LoadRequested{false};
+    std::atomic<bool> state_LoadPending{false};
+    QString state_SaveFile;
+    QString state_IssuedFile;
+    QString state_CaptureFile;
+    QString state_CapturedFile;
+    QString state_LoadRequestFile;
+    QImage state_Screen;
+    QImage state_CapturedScreen;
+    int state_Slot = 0;
+
+    bool state_Save(QString);
+    void state_SaveIssue(void);
+    void state_Saved(bool);
+    void state_LoadIssue(void);
+    void state_LoadFailed(void);
+    bool state_IsBusy(void);
+    QImage state_ReadScreen(void);
+    bool state_SaveToFile(QString);
+    bool state_LoadFromFile(QString);
+
+    std::atomic<quint64> frame_Count{0};
+    std::atomic<quint64> frame_Limit{0};
+    std::atomic<bool> speed_Limited{true};
+    std::atomic<int> speed_Factor{100};
+    std::atomic<bool> audio_Muted{false};
+    Utilities::ThreadClock cpu_Clock;
+
+    std::atomic<bool> present_Skipped{false};
+
+    QMutex debug_Mutex;
+    QStringList debug_Messages;
+
+    Utilities::RewindBuffer rewind_Buffer;
+    std::atomic<bool> rewind_Enabled{false};
+    std::atomic<bool> rewind_Active{false};
+    std::atomic<bool> rewind_SavePending{false};
+    std::atomic<bool> rewind_LoadPending{false};
+    int rewind_Interval = 1;
+    QString rewind_File;
+
+    void rewind_Frame(quint64);
+    void rewind_SaveComplete(bool);
+
+    int runahead_Frames = 0;
+    int runahead_Phase = 0;
+    std::atomic<bool> runahead_Hidden{false};
+    std::atomic<bool> runahead_Muted{false};
+    std::atomic<bool> runahead_SavePending{false};
+    std::atomic<bool> runahead_LoadPending{false};
+    QString runahead_File;
+    QString runahead_StateFile;
+    QElapsedTimer runahead_Timer;
+    qint64 runahead_SaveTime = 0;
+    std::atomic<qint64> runahead_StateTime{0};
+
+    void runahead_Frame(void);
+    void runahead_Reset(void);
+    void runahead_Loaded(void);
+    void runahead_SetMuted(bool);
+
+    std::atomic<bool> suspend_Pending{false};
+    std::atomic<bool> resume_LoadPending{false};
+    QString resume_File;
+
+    static void core_StateCallback(void *, m64p_core_param, int);
+    static void core_FrameCallback(unsigned int);
 
     RomInfo_t rom_Info;
 
@@ -98,6 +256,10 @@ class Core
 
     bool core_ApplyOverlay(void);
 
+    QTemporaryDir *core_TempDir = nullptr;
+    QString core_TempFile(QString);
+
+    bool emulation_Stop(void);
     bool emulation_QueryState(m64p_emu_state *);
     bool emulation_IsRunning(void);
     bool emulation_IsPaused(void);
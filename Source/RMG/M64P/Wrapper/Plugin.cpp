@@ -10,6 +10,7 @@
 #include "Plugin.hpp"
 #include "../Api.hpp"
 #include "../Macros.hpp"
+#include "Core.hpp"
 #include "Types.hpp"
 
 #include <QFileInfo>
@@ -63,7 +64,10 @@ bool Plugin::Startup(void)
 {
     m64p_error ret;
 
-    ret = this->plugin.Startup(this->coreHandle, NULL, NULL);
+    // its messages end up in hang reports
+    this->debug_Name = QFileInfo(this->fileName).completeBaseName().toUtf8();
+
+    ret = this->plugin.Startup(this->coreHandle, (void *)this->debug_Name.constData(), Core::DebugCallback);
     if (ret != M64ERR_SUCCESS)
     {
         this->error_Message = "Plugin::Startup Failed: ";
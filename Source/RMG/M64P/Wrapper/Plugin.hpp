@@ -14,6 +14,7 @@
 #include "../api/m64p_types.h"
 #include "Types.hpp"
 
+#include <QByteArray>
 #include <QString>
 
 namespace M64P
@@ -58,6 +59,9 @@ class Plugin
 
     Plugin_t plugin_t;
     bool plugin_t_Get(void);
+
+    // handed to the plugin as its debug context
+    QByteArray debug_Name;
 };
 } // namespace Wrapper
 } // namespace M64P
@@ -11,26 +11,174 @@
 #include "../../Globals.hpp"
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QGuiApplication>
 #include <QOpenGLContext>
+#include <QScreen>
+#include <QSemaphore>
 #include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <memory>
 
 static QSurfaceFormat format;
 static QThread *renderThread;
 
+// headless mode never touches the GUI,
+// the plugin renders into an offscreen surface only
+static bool headless = false;
+static UserInterface::Widget::OGLFrameQueue headless_Queue;
+
+static UserInterface::Widget::OGLFrameQueue *VidExt_GetFrameQueue(void)
+{
+    if (headless)
+        return &headless_Queue;
+
+    if (g_OGLWidget->IsOffscreen())
+        return g_OGLWidget->GetFrameQueue();
+
+    return nullptr;
+}
+
+// frame times, used to compare presentation modes
+static QElapsedTimer frame_Timer;
+static Utilities::FrameStats frame_Stats;
+
+static void VidExt_ResetFrameTimes(void)
+{
+    frame_Timer.invalidate();
+    frame_Stats.Reset();
+}
+
+static void VidExt_LogFrameTimes(void)
+{
+    QString mode = "headless";
+    if (!headless)
+    {
+        mode = g_OGLWidget->IsEmbedded() ? "embedded" : "native";
+        if (g_OGLWidget->IsOffscreen())
+            mode += " offscreen";
+    }
+
+    g_Logger.AddText("VidExt: " + mode + " presentation, " + frame_Stats.GetSummary());
+}
+
+Utilities::FrameStats *VidExt_GetFrameStats(void)
+{
+    return &frame_Stats;
+}
+
+void VidExt_SetHeadless(bool enabled)
+{
+    headless = enabled;
+}
+
+// runs func on the GUI thread and waits for it to finish,
+// the semaphore is shared so a late func can't touch a dead stack
+static bool VidExt_Invoke(QString name, std::function<void(void)> func)
+{
+    std::shared_ptr<QSemaphore> done = std::make_shared<QSemaphore>();
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    if (QThread::currentThread() == QApplication::instance()->thread())
+    {
+        func();
+        return true;
+    }
+
+    // whoever sets the flag first decides, so func
+    // either runs in full or not at all
+    QMetaObject::invokeMethod(
+        QApplication::instance(),
+        [func, done, cancelled]() {
+            if (cancelled->exchange(true))
+                return;
+            func();
+            done->release();
+        },
+        Qt::QueuedConnection);
+
+    if (!done->tryAcquire(1, APP_VIDEXT_TIMEOUT))
+    {
+        // the core has given up on it by now, a late func
+        // would act on a state nobody expects anymore
+        if (!cancelled->exchange(true))
+        {
+            g_Logger.AddText(name + ": timed out waiting for the GUI thread");
+            return false;
+        }
+
+        // it started just in time, let it finish
+        done->acquire();
+    }
+
+    return true;
+}
+
 static bool ogl_setup = false;
-static void VidExt_OglSetup(void)
+static bool VidExt_OglSetup(void)
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    g_EmuThread->on_VidExt_SetupOGL(format, QThread::currentThread());
+    QElapsedTimer timer;
+    QThread *thread = QThread::currentThread();
 
-    while (!g_OGLWidget->isValid())
-        continue;
+    timer.start();
+
+    if (headless)
+    {
+        // QOffscreenSurface has to be created on the GUI thread
+        if (!VidExt_Invoke("VidExt_OglSetup", []() { headless_Queue.CreateSurface(format); }))
+            return false;
+    }
+    else if (!VidExt_Invoke("VidExt_OglSetup", [thread]() { g_EmuThread->on_VidExt_SetupOGL(format, thread); }))
+    {
+        return false;
+    }
+
+    // the plugin renders into our own framebuffer,
+    // the GUI thread keeps its context for presenting
+    UserInterface::Widget::OGLFrameQueue *queue = VidExt_GetFrameQueue();
+    if (queue != nullptr)
+    {
+        if (!queue->Init(format))
+        {
+            g_Logger.AddText("VidExt_OglSetup: " + queue->GetLastError());
+            return false;
+        }
+
+        ogl_setup = true;
+
+        if (!headless)
+        {
+            VidExt_Invoke("VidExt_OglSetup",
+                          []() { frame_Stats.SetRefreshRate(g_OGLWidget->screen()->refreshRate()); });
+        }
+
+        g_Logger.AddText("VidExt_OglSetup: offscreen OpenGL context " +
+                         QString(queue->IsReused() ? "re-used" : "created") + ", ready in " +
+                         QString::number(timer.elapsed()) + "ms");
+        return true;
+    }
+
+    if (!g_OGLWidget->WaitForValid(APP_VIDEXT_TIMEOUT))
+    {
+        g_Logger.AddText("VidExt_OglSetup: timed out waiting for the OpenGL context");
+        return false;
+    }
 
     g_OGLWidget->makeCurrent();
+    g_OGLWidget->ResetContextState();
 
     ogl_setup = true;
+
+    VidExt_Invoke("VidExt_OglSetup", []() { frame_Stats.SetRefreshRate(g_OGLWidget->screen()->refreshRate()); });
+
+    g_Logger.AddText("VidExt_OglSetup: OpenGL context ready in " + QString::number(timer.elapsed()) + "ms, " +
+                     g_OGLWidget->GetContextDiagnostics());
+    return true;
 }
 
 m64p_error VidExt_Init(void)
@@ -39,6 +187,8 @@ m64p_error VidExt_Init(void)
 
     renderThread = QThread::currentThread();
 
+    VidExt_ResetFrameTimes();
+
     format = QSurfaceFormat::defaultFormat();
     format.setOption(QSurfaceFormat::DeprecatedFunctions, 1);
     format.setDepthBufferSize(24);
@@ -46,7 +196,11 @@ m64p_error VidExt_Init(void)
     format.setMajorVersion(2);
     format.setMinorVersion(1);
 
-    g_EmuThread->on_VidExt_Init();
+    if (headless)
+        return M64ERR_SUCCESS;
+
+    if (!VidExt_Invoke("VidExt_Init", []() { g_EmuThread->on_VidExt_Init(); }))
+        return M64ERR_SYSTEM_FAIL;
 
     return M64ERR_SUCCESS;
 }
@@ -55,20 +209,77 @@ m64p_error VidExt_Quit(void)
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    g_OGLWidget->SetThread(QApplication::instance()->thread());
-    g_EmuThread->on_VidExt_Quit();
+    VidExt_LogFrameTimes();
+
+    if (headless)
+    {
+        headless_Queue.Quit();
+        VidExt_Invoke("VidExt_Quit", []() { headless_Queue.DestroySurface(); });
+    }
+    else if (g_OGLWidget->IsOffscreen())
+    {
+        g_OGLWidget->GetFrameQueue()->Quit();
+        VidExt_Invoke("VidExt_Quit", []() {
+            g_OGLWidget->GetFrameQueue()->DestroySurface();
+            g_EmuThread->on_VidExt_Quit();
+        });
+    }
+    else
+    {
+        g_OGLWidget->SetThread(QApplication::instance()->thread());
+        VidExt_Invoke("VidExt_Quit", []() { g_EmuThread->on_VidExt_Quit(); });
+    }
     ogl_setup = false;
 
     return M64ERR_SUCCESS;
 }
 
+// QScreen only knows about the current mode of each screen,
+// so those are what we report, largest first
+static QList<QPair<QSize, int>> VidExt_GetScreenModes(void)
+{
+    std::shared_ptr<QList<QPair<QSize, int>>> result = std::make_shared<QList<QPair<QSize, int>>>();
+
+    if (!VidExt_Invoke("VidExt_GetScreenModes", [result]() {
+            for (QScreen *screen : QGuiApplication::screens())
+            {
+                QSize size = screen->size() * screen->devicePixelRatio();
+                result->append(qMakePair(size, qRound(screen->refreshRate())));
+            }
+        }))
+    {
+        return QList<QPair<QSize, int>>();
+    }
+
+    QList<QPair<QSize, int>> modes = *result;
+
+    std::sort(modes.begin(), modes.end(), [](const QPair<QSize, int> &a, const QPair<QSize, int> &b) {
+        return (a.first.width() * a.first.height()) > (b.first.width() * b.first.height());
+    });
+
+    return modes;
+}
+
 m64p_error VidExt_ListModes(m64p_2d_size *SizeArray, int *NumSizes)
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    SizeArray[0].uiHeight = 1080;
-    SizeArray[0].uiWidth = 1920;
-    *NumSizes = 1;
+    QList<QPair<QSize, int>> modes = VidExt_GetScreenModes();
+    QList<QSize> sizes;
+
+    for (const QPair<QSize, int> &mode : modes)
+    {
+        if (!sizes.contains(mode.first))
+            sizes.append(mode.first);
+    }
+
+    int count = qMin(*NumSizes, sizes.count());
+    for (int i = 0; i < count; i++)
+    {
+        SizeArray[i].uiWidth = sizes.at(i).width();
+        SizeArray[i].uiHeight = sizes.at(i).height();
+    }
+    *NumSizes = count;
 
     return M64ERR_SUCCESS;
 }
@@ -77,8 +288,24 @@ m64p_error VidExt_ListRates(m64p_2d_size Size, int *NumRates, int *Rates)
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    Rates[0] = 60;
-    *NumRates = 1;
+    QList<QPair<QSize, int>> modes = VidExt_GetScreenModes();
+    QList<int> rates;
+
+    for (const QPair<QSize, int> &mode : modes)
+    {
+        if (mode.first != QSize(Size.uiWidth, Size.uiHeight))
+            continue;
+
+        if (!rates.contains(mode.second))
+            rates.append(mode.second);
+    }
+
+    int count = qMin(*NumRates, rates.count());
+    for (int i = 0; i < count; i++)
+    {
+        Rates[i] = rates.at(i);
+    }
+    *NumRates = count;
 
     return M64ERR_SUCCESS;
 }
@@ -87,10 +314,19 @@ m64p_error VidExt_SetMode(int Width, int Height, int BitsPerPixel, int ScreenMod
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    if (!ogl_setup)
-        VidExt_OglSetup();
+    if (!ogl_setup && !VidExt_OglSetup())
+        return M64ERR_SYSTEM_FAIL;
 
-    g_EmuThread->on_VidExt_SetMode(Width, Height, BitsPerPixel, ScreenMode, Flags);
+    UserInterface::Widget::OGLFrameQueue *queue = VidExt_GetFrameQueue();
+    if (queue != nullptr)
+        queue->SetSize(Width, Height);
+
+    if (headless)
+        return M64ERR_SUCCESS;
+
+    VidExt_Invoke("VidExt_SetMode", [=]() {
+        g_EmuThread->on_VidExt_SetMode(Width, Height, BitsPerPixel, ScreenMode, Flags);
+    });
     return M64ERR_SUCCESS;
 }
 
@@ -98,17 +334,29 @@ m64p_error VidExt_SetModeWithRate(int Width, int Height, int RefreshRate, int Bi
 {
     std::cout << __FUNCTION__ << std::endl;
 
-    if (!ogl_setup)
-        VidExt_OglSetup();
+    if (!ogl_setup && !VidExt_OglSetup())
+        return M64ERR_SYSTEM_FAIL;
+
+    UserInterface::Widget::OGLFrameQueue *queue = VidExt_GetFrameQueue();
+    if (queue != nullptr)
+        queue->SetSize(Width, Height);
 
-    g_EmuThread->on_VidExt_SetModeWithRate(Width, Height, RefreshRate, BitsPerPixel, ScreenMode, Flags);
+    if (headless)
+        return M64ERR_SUCCESS;
+
+    VidExt_Invoke("VidExt_SetModeWithRate", [=]() {
+        g_EmuThread->on_VidExt_SetModeWithRate(Width, Height, RefreshRate, BitsPerPixel, ScreenMode, Flags);
+    });
     return M64ERR_SUCCESS;
 }
 
 m64p_function VidExt_GLGetProc(const char *Proc)
 {
     std::cout << __FUNCTION__ << std::endl;
-    return g_OGLWidget->context()->getProcAddress(Proc);
+    if (headless)
+        return headless_Queue.GetContext()->getProcAddress(Proc);
+
+    return g_OGLWidget->GetRenderContext()->getProcAddress(Proc);
 }
 
 m64p_error VidExt_GLSetAttr(m64p_GLattr Attr, int Value)
@@ -242,10 +490,39 @@ m64p_error VidExt_GLSwapBuf(void)
     if (renderThread != QThread::currentThread())
         return M64ERR_UNSUPPORTED;
 
-    g_OGLWidget->context()->swapBuffers(g_OGLWidget->context()->surface());
+    // frames run-ahead emulates but rolls back, would
+    // make the picture jump back, and a hidden window
+    // has no use for them either
+    if (g_MupenApi.Core.IsFrameHidden())
+        return M64ERR_SUCCESS;
 
-    // TODO, figure out why this is needed?
-    // g_OGLWidget->context()->makeCurrent(g_OGLWidget->context()->surface());
+    QElapsedTimer swapTimer;
+    swapTimer.start();
+
+    if (headless)
+    {
+        headless_Queue.Swap();
+    }
+    else if (g_OGLWidget->IsOffscreen())
+    {
+        g_OGLWidget->GetFrameQueue()->Swap();
+        QMetaObject::invokeMethod(g_OGLWidget, "update", Qt::QueuedConnection);
+    }
+    else
+    {
+        // the overlay restores whatever state it touches
+        QSize size = g_OGLWidget->size() * g_OGLWidget->devicePixelRatio();
+        g_OGLWidget->GetTextOverlay()->Render(g_OGLWidget->context(), g_OGLWidget->defaultFramebufferObject(), size);
+
+        g_OGLWidget->context()->swapBuffers(g_OGLWidget->context()->surface());
+
+        // TODO, figure out why this is needed?
+        // g_OGLWidget->context()->makeCurrent(g_OGLWidget->context()->surface());
+    }
+
+    if (frame_Timer.isValid())
+        frame_Stats.AddFrame(frame_Timer.nsecsElapsed(), swapTimer.nsecsElapsed());
+    frame_Timer.start();
 
     return M64ERR_SUCCESS;
 }
@@ -253,26 +530,46 @@ m64p_error VidExt_GLSwapBuf(void)
 m64p_error VidExt_SetCaption(const char *Title)
 {
     std::cout << __FUNCTION__ << std::endl;
-    g_EmuThread->on_VidExt_SetCaption(QString(Title));
+    QString title(Title);
+    if (headless)
+        return M64ERR_SUCCESS;
+
+    VidExt_Invoke("VidExt_SetCaption", [title]() { g_EmuThread->on_VidExt_SetCaption(title); });
     return M64ERR_SUCCESS;
 }
 
 m64p_error VidExt_ToggleFS(void)
 {
     std::cout << __FUNCTION__ << std::endl;
-    g_EmuThread->on_VidExt_ToggleFS();
+    if (headless)
+        return M64ERR_UNSUPPORTED;
+
+    VidExt_Invoke("VidExt_ToggleFS", []() { g_EmuThread->on_VidExt_ToggleFS(); });
     return M64ERR_SUCCESS;
 }
 
 m64p_error VidExt_ResizeWindow(int Width, int Height)
 {
     std::cout << __FUNCTION__ << std::endl;
-    g_EmuThread->on_VidExt_ResizeWindow(Width, Height);
+
+    UserInterface::Widget::OGLFrameQueue *queue = VidExt_GetFrameQueue();
+    if (queue != nullptr)
+        queue->SetSize(Width, Height);
+
+    if (headless)
+        return M64ERR_SUCCESS;
+
+    VidExt_Invoke("VidExt_ResizeWindow", [=]() { g_EmuThread->on_VidExt_ResizeWindow(Width, Height); });
     return M64ERR_SUCCESS;
 }
 
 uint32_t VidExt_GLGetDefaultFramebuffer(void)
 {
     std::cout << __FUNCTION__ << std::endl;
+
+    UserInterface::Widget::OGLFrameQueue *queue = VidExt_GetFrameQueue();
+    if (queue != nullptr)
+        return queue->GetFramebuffer();
+
     return 0;
 }
@@ -11,6 +11,7 @@
 #define VIDEXT_HPP
 
 #include "../../Thread/EmulationThread.hpp"
+#include "../../Utilities/FrameStats.hpp"
 #include "../api/m64p_types.h"
 #include <QOpenGLWidget>
 
@@ -29,4 +30,7 @@ m64p_error VidExt_ToggleFS(void);
 m64p_error VidExt_ResizeWindow(int, int);
 uint32_t VidExt_GLGetDefaultFramebuffer(void);
 
+Utilities::FrameStats *VidExt_GetFrameStats(void);
+void VidExt_SetHeadless(bool);
+
 #endif // VIDEXT_HPP
\ No newline at end of file
@@ -9,6 +9,7 @@
  */
 #include "EmulationThread.hpp"
 #include "../Globals.hpp"
+#include "../Utilities/SettingsID.hpp"
 
 using namespace Thread;
 
@@ -30,15 +31,69 @@ void EmulationThread::run(void)
     emit this->on_Emulation_Started();
 
     bool ret;
+    bool lockMemory = g_Settings.GetBoolValue(SettingsID::GUI_LockMemory);
+
+    this->thread_Setup();
 
     ret = g_MupenApi.Core.LaunchEmulation(this->rom_File);
 
     if (!ret)
         this->error_Message = g_MupenApi.Core.GetLastError();
 
+    if (lockMemory && !this->thread_Scheduler.LockMemory(false))
+        g_Logger.AddText("EmulationThread::run: " + this->thread_Scheduler.GetLastError());
+
+    Utilities::ThreadScheduler::SetBackgroundIdle(false);
+
     emit this->on_Emulation_Finished(ret);
 }
 
+void EmulationThread::thread_Setup(void)
+{
+    Utilities::ThreadScheduler *scheduler = &this->thread_Scheduler;
+
+    QString cpus = g_Settings.GetStringValue(SettingsID::GUI_CpuAffinity);
+
+    this->thread_Cpus = Utilities::ThreadScheduler::ParseCpuList(cpus);
+
+    // QThread starts a new thread every time,
+    // so nothing from the last session carries over
+    if (!this->thread_Cpus.isEmpty() && !scheduler->SetAffinity(this->thread_Cpus))
+        g_Logger.AddText("EmulationThread::thread_Setup: " + scheduler->GetLastError());
+
+    // real-time needs privileges, nice
+    // is the fallback when they're missing
+    if (!g_Settings.GetBoolValue(SettingsID::GUI_RealtimePriority) || !scheduler->SetRealtime())
+    {
+        if (g_Settings.GetBoolValue(SettingsID::GUI_RealtimePriority))
+            g_Logger.AddText("EmulationThread::thread_Setup: " + scheduler->GetLastError());
+
+        int nice = g_Settings.GetIntValue(SettingsID::GUI_Nice);
+        if (nice != 0 && !scheduler->SetNice(nice))
+            g_Logger.AddText("EmulationThread::thread_Setup: " + scheduler->GetLastError());
+    }
+
+    if (g_Settings.GetBoolValue(SettingsID::GUI_LockMemory) && !scheduler->LockMemory(true))
+        g_Logger.AddText("EmulationThread::thread_Setup: " + scheduler->GetLastError());
+
+    Utilities::ThreadScheduler::SetBackgroundIdle(g_Settings.GetBoolValue(SettingsID::GUI_DemoteBackground));
+
+    // everything running now isn't the plugins'
+    scheduler->TakeNewThreads();
+}
+
+void EmulationThread::SetSessionThreadAffinity(void)
+{
+    if (this->thread_Cpus.isEmpty())
+        return;
+
+    for (qint64 thread : this->thread_Scheduler.TakeNewThreads())
+    {
+        if (!this->thread_Scheduler.SetAffinity(thread, this->thread_Cpus))
+            g_Logger.AddText("EmulationThread::SetSessionThreadAffinity: " + this->thread_Scheduler.GetLastError());
+    }
+}
+
 QString EmulationThread::GetLastError(void)
 {
     return this->error_Message;
@@ -11,7 +11,9 @@
 #define EMULATIONTHREAD_HPP
 
 //#include "../Globals.hpp"
+#include "../Utilities/ThreadScheduler.hpp"
 
+#include <QList>
 #include <QString>
 #include <QSurfaceFormat>
 #include <QThread>
@@ -32,13 +34,26 @@ class EmulationThread : public QThread
 
     QString GetLastError(void);
 
+    // pins the threads plugins started for
+    // this session to the emulation thread's cores
+    void SetSessionThreadAffinity(void);
+
   private:
     QString rom_File;
     QString error_Message;
 
+    Utilities::ThreadScheduler thread_Scheduler;
+    QList<int> thread_Cpus;
+
+    void thread_Setup(void);
+
   signals:
     void on_Emulation_Started(void);
     void on_Emulation_Finished(bool);
+    void on_Emulation_PluginSwapped(bool, int);
+    void on_Emulation_StateSaved(bool, QString);
+    void on_Emulation_StateLoaded(bool);
+    void on_Emulation_CoreStateChanged(int);
 
     void on_VidExt_SetupOGL(QSurfaceFormat, QThread *);
     void on_VidExt_ResizeWindow(int, int);
@@ -0,0 +1,161 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PluginProbeThread.hpp"
+#include "../Globals.hpp"
+#include "Config.hpp"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+
+using namespace Thread;
+using namespace M64P::Wrapper;
+
+struct PluginProbeWorker_t
+{
+    QString FileName;
+    QProcess *Process;
+};
+
+PluginProbeThread::PluginProbeThread(void) : QThread(nullptr)
+{
+    qRegisterMetaType<M64P::Wrapper::Plugin_t>("M64P::Wrapper::Plugin_t");
+}
+
+PluginProbeThread::~PluginProbeThread(void)
+{
+}
+
+void PluginProbeThread::run(void)
+{
+    QList<PluginProbeWorker_t> workers;
+    PluginProbeWorker_t worker;
+    QStringList files;
+    QString probeFile;
+    Plugin_t plugin;
+    int maxWorkers, index = 0;
+
+    this->plugin_List.clear();
+
+    probeFile = QCoreApplication::applicationDirPath() + "/" APP_PLUGINPROBE_FILE;
+    if (!QFile::exists(probeFile))
+    {
+        g_Logger.AddText("PluginProbeThread::run: " APP_PLUGINPROBE_FILE " not found");
+        return;
+    }
+
+    maxWorkers = QThread::idealThreadCount();
+    if (maxWorkers < 1)
+        maxWorkers = 1;
+
+    files = this->probe_GetFiles();
+
+    while (index < files.size() || !workers.isEmpty())
+    {
+        // keep every worker slot busy
+        while (workers.size() < maxWorkers && index < files.size())
+        {
+            worker.FileName = files.at(index++);
+            worker.Process = new QProcess();
+            worker.Process->setProgram(probeFile);
+            worker.Process->setArguments(QStringList() << worker.FileName);
+            worker.Process->start(QIODevice::ReadOnly);
+            workers.append(worker);
+        }
+
+        worker = workers.takeFirst();
+
+        if (!worker.Process->waitForFinished(APP_PLUGINPROBE_TIMEOUT))
+        {
+            g_Logger.AddText("PluginProbeThread::run: " + worker.FileName + " timed out");
+            worker.Process->kill();
+            worker.Process->waitForFinished();
+        }
+        else if (worker.Process->exitStatus() != QProcess::NormalExit || worker.Process->exitCode() != 0)
+        {
+            g_Logger.AddText("PluginProbeThread::run: " + worker.FileName + " failed: " +
+                             QString(worker.Process->readAllStandardError()));
+        }
+        else if (this->probe_Parse(worker.FileName, worker.Process->readAllStandardOutput(), &plugin))
+        {
+            this->plugin_List.append(plugin);
+            emit this->on_Plugin_Found(plugin);
+        }
+
+        delete worker.Process;
+    }
+}
+
+QList<Plugin_t> PluginProbeThread::GetPlugins(void)
+{
+    return this->plugin_List;
+}
+
+QStringList PluginProbeThread::probe_GetFiles(void)
+{
+    QStringList files;
+    QStringList dirs;
+    QStringList filter;
+
+    dirs << MUPEN_DIR_GFX;
+    dirs << MUPEN_DIR_RSP;
+    dirs << MUPEN_DIR_AUDIO;
+    dirs << MUPEN_DIR_INPUT;
+
+    filter << "*." SO_EXT;
+
+    for (const QString &dir : dirs)
+    {
+        for (const QFileInfo &info : QDir(dir).entryInfoList(filter))
+            files.append(info.filePath());
+    }
+
+    return files;
+}
+
+bool PluginProbeThread::probe_Parse(QString file, QByteArray output, Plugin_t *plugin)
+{
+    QStringList fields = QString(output).trimmed().split('\t');
+
+    if (fields.size() != 5)
+        return false;
+
+    switch ((m64p_plugin_type)fields.at(0).toInt())
+    {
+    case M64PLUGIN_GFX:
+        plugin->Type = PluginType::Gfx;
+        break;
+    case M64PLUGIN_AUDIO:
+        plugin->Type = PluginType::Audio;
+        break;
+    case M64PLUGIN_RSP:
+        plugin->Type = PluginType::Rsp;
+        break;
+    case M64PLUGIN_INPUT:
+        plugin->Type = PluginType::Input;
+        break;
+    default:
+        return false;
+    }
+
+    plugin->FileName = file;
+    plugin->Version = fields.at(1).toInt();
+    plugin->ApiVersion = fields.at(2).toInt();
+    plugin->Capabilities = fields.at(3).toInt();
+    plugin->Name = fields.at(4);
+
+    // if plugin doesn't provide us with a name,
+    // use basename of filepath instead
+    if (plugin->Name.isEmpty())
+        plugin->Name = QFileInfo(file).fileName();
+
+    return true;
+}
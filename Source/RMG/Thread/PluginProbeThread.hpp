@@ -0,0 +1,46 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PLUGINPROBETHREAD_HPP
+#define PLUGINPROBETHREAD_HPP
+
+#include "../M64P/Wrapper/Types.hpp"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+namespace Thread
+{
+class PluginProbeThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    PluginProbeThread(void);
+    ~PluginProbeThread(void);
+
+    void run(void) override;
+
+    QList<M64P::Wrapper::Plugin_t> GetPlugins(void);
+
+  private:
+    QList<M64P::Wrapper::Plugin_t> plugin_List;
+
+    QStringList probe_GetFiles(void);
+    bool probe_Parse(QString, QByteArray, M64P::Wrapper::Plugin_t *);
+
+  signals:
+    void on_Plugin_Found(M64P::Wrapper::Plugin_t);
+};
+} // namespace Thread
+
+#endif // PLUGINPROBETHREAD_HPP
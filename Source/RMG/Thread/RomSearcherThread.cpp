@@ -40,6 +40,9 @@ void RomSearcherThread::SetMaximumFiles(int value)
 
 void RomSearcherThread::run(void)
 {
+    // every run is a new thread at normal priority
+    this->rom_Scheduler = Utilities::ThreadScheduler();
+
     this->rom_Search_Count = 0;
     this->rom_Search(this->rom_Directory);
     return;
@@ -63,6 +66,9 @@ void RomSearcherThread::rom_Search(QString directory)
     {
         fileInfo = fileList.at(i);
 
+        // idle while a game runs, when asked to
+        this->rom_Scheduler.FollowBackground();
+
         ret = this->rom_Get_Info(fileInfo.absoluteFilePath(), &romInfo);
         if (ret)
         {
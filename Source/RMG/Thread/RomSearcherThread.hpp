@@ -11,6 +11,7 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include "../Globals.hpp"
+#include "../Utilities/ThreadScheduler.hpp"
 
 #include <QString>
 #include <QThread>
@@ -37,6 +38,8 @@ class RomSearcherThread : public QThread
     int rom_Search_MaxItems;
     int rom_Search_Count;
 
+    Utilities::ThreadScheduler rom_Scheduler;
+
     void rom_Search(QString);
     bool rom_Get_Info(QString, M64P::Wrapper::RomInfo_t *);
 
@@ -0,0 +1,249 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SaveStateDialog.hpp"
+#include "../../Config.hpp"
+#include "../../Globals.hpp"
+#include "Utilities/SettingsID.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QImageReader>
+#include <QLocale>
+#include <QPushButton>
+#include <QRunnable>
+#include <QVBoxLayout>
+
+using namespace UserInterface::Dialog;
+
+// thumbnails are 4:3, so this is the size of every row's icon
+#define THUMBNAIL_SIZE QSize(APP_SAVESTATE_THUMBNAIL_WIDTH, APP_SAVESTATE_THUMBNAIL_WIDTH * 3 / 4)
+#define THUMBNAIL_CACHE_SIZE 64
+
+class ThumbnailLoader : public QRunnable
+{
+  public:
+    ThumbnailLoader(QObject *model, QString key, QString file) : model(model), key(key), file(file)
+    {
+    }
+
+    void run(void) Q_DECL_OVERRIDE
+    {
+        QImageReader reader(this->file);
+        QImage image;
+
+        // the thumbnail might be missing, the
+        // model still needs to hear back about it
+        if (reader.canRead())
+        {
+            image = reader.read();
+            if (!image.isNull())
+                image = image.scaled(THUMBNAIL_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+
+        QMetaObject::invokeMethod(this->model, "on_Thumbnail_Loaded", Qt::QueuedConnection,
+                                  Q_ARG(QString, this->key), Q_ARG(QImage, image));
+    }
+
+  private:
+    QObject *model;
+    QString key;
+    QString file;
+};
+
+SaveStateModel::SaveStateModel(QObject *parent) : QAbstractListModel(parent)
+{
+    this->state_Placeholder = QPixmap(THUMBNAIL_SIZE);
+    this->state_Placeholder.fill(Qt::black);
+
+    this->thumbnail_Cache.setMaxCost(THUMBNAIL_CACHE_SIZE);
+    this->thumbnail_Pool.setMaxThreadCount(2);
+}
+
+SaveStateModel::~SaveStateModel(void)
+{
+    // loaders hold a pointer to us
+    this->thumbnail_Pool.clear();
+    this->thumbnail_Pool.waitForDone();
+}
+
+void SaveStateModel::SetStates(QFileInfoList list)
+{
+    this->beginResetModel();
+    this->state_List = list;
+    this->endResetModel();
+}
+
+QString SaveStateModel::GetFile(const QModelIndex &index)
+{
+    if (!index.isValid() || index.row() >= this->state_List.size())
+        return QString();
+
+    return this->state_List.at(index.row()).absoluteFilePath();
+}
+
+int SaveStateModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return this->state_List.size();
+}
+
+QVariant SaveStateModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->state_List.size())
+        return QVariant();
+
+    const QFileInfo &info = this->state_List.at(index.row());
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return info.fileName() + "\n" + QLocale().toString(info.lastModified(), QLocale::ShortFormat);
+    case Qt::ToolTipRole:
+        return info.absoluteFilePath();
+    case Qt::DecorationRole: {
+        QPixmap *pixmap = this->thumbnail_Cache.object(this->thumbnail_Key(info));
+        if (pixmap != nullptr)
+            return *pixmap;
+
+        // only called for rows that are painted,
+        // so only those thumbnails get read
+        this->thumbnail_Load(info);
+        return this->state_Placeholder;
+    }
+    case Qt::SizeHintRole:
+        return QSize(0, THUMBNAIL_SIZE.height() + 8);
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+QString SaveStateModel::thumbnail_Key(const QFileInfo &info) const
+{
+    // a resaved slot needs a new thumbnail
+    return info.absoluteFilePath() + "|" + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+void SaveStateModel::thumbnail_Load(const QFileInfo &info) const
+{
+    QString key = this->thumbnail_Key(info);
+
+    if (this->thumbnail_Pending.contains(key))
+        return;
+
+    this->thumbnail_Pending.insert(key);
+    this->thumbnail_Pool.start(new ThumbnailLoader((QObject *)this, key, info.absoluteFilePath() + ".png"));
+}
+
+void SaveStateModel::on_Thumbnail_Loaded(QString key, QImage image)
+{
+    this->thumbnail_Pending.remove(key);
+
+    // states without a thumbnail keep the placeholder,
+    // caching it prevents reading them over and over
+    if (image.isNull())
+        this->thumbnail_Cache.insert(key, new QPixmap(this->state_Placeholder));
+    else
+        this->thumbnail_Cache.insert(key, new QPixmap(QPixmap::fromImage(image)));
+
+    for (int i = 0; i < this->state_List.size(); i++)
+    {
+        if (this->thumbnail_Key(this->state_List.at(i)) == key)
+        {
+            QModelIndex index = this->index(i);
+            emit this->dataChanged(index, index, {Qt::DecorationRole});
+            break;
+        }
+    }
+}
+
+SaveStateDialog::SaveStateDialog(QWidget *parent) : QDialog(parent, Qt::WindowSystemMenuHint | Qt::WindowTitleHint)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    this->setWindowTitle("Save States");
+    this->resize(480, 520);
+
+    this->model = new SaveStateModel(this);
+
+    // uniform rows let the view skip measuring
+    // every row, which keeps large lists instant
+    this->listView = new QListView(this);
+    this->listView->setModel(this->model);
+    this->listView->setUniformItemSizes(true);
+    this->listView->setIconSize(THUMBNAIL_SIZE);
+    this->listView->setSelectionMode(QAbstractItemView::SingleSelection);
+    this->listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(this->listView);
+
+    this->buttonBox = new QDialogButtonBox(QDialogButtonBox::Open | QDialogButtonBox::Cancel, this);
+    this->buttonBox->button(QDialogButtonBox::Open)->setText("Load");
+    layout->addWidget(this->buttonBox);
+
+    connect(this->listView, &QListView::activated, this, &SaveStateDialog::on_ListView_Activated);
+    connect(this->buttonBox, &QDialogButtonBox::accepted, this, &SaveStateDialog::accept);
+    connect(this->buttonBox, &QDialogButtonBox::rejected, this, &SaveStateDialog::reject);
+
+    this->loadStates();
+}
+
+SaveStateDialog::~SaveStateDialog(void)
+{
+}
+
+void SaveStateDialog::loadStates(void)
+{
+    M64P::Wrapper::RomInfo_t romInfo = {0};
+    QFileInfoList states;
+    QString goodName;
+
+    if (!g_MupenApi.Core.GetRomInfo(&romInfo))
+        return;
+
+    goodName = QString(romInfo.Settings.goodname);
+
+    // good names are full of brackets,
+    // which QDir would take as wildcards
+    QDir dir(g_Settings.GetStringValue(SettingsID::Core_SaveStatePath));
+    for (const QFileInfo &info : dir.entryInfoList(QDir::Files, QDir::Time))
+    {
+        if (info.fileName().startsWith(goodName) && info.suffix() != "png")
+            states.append(info);
+    }
+
+    this->model->SetStates(states);
+
+    if (!states.isEmpty())
+        this->listView->setCurrentIndex(this->model->index(0));
+}
+
+void SaveStateDialog::on_ListView_Activated(const QModelIndex &index)
+{
+    Q_UNUSED(index);
+    this->accept();
+}
+
+QString SaveStateDialog::GetSelectedFile(void)
+{
+    return this->selectedFile;
+}
+
+void SaveStateDialog::accept(void)
+{
+    this->selectedFile = this->model->GetFile(this->listView->currentIndex());
+
+    if (this->selectedFile.isEmpty())
+        return;
+
+    QDialog::accept();
+}
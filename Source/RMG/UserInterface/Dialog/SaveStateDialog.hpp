@@ -0,0 +1,85 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SAVESTATEDIALOG_HPP
+#define SAVESTATEDIALOG_HPP
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFileInfo>
+#include <QImage>
+#include <QListView>
+#include <QPixmap>
+#include <QSet>
+#include <QThreadPool>
+
+namespace UserInterface
+{
+namespace Dialog
+{
+// Lists the savestates of a game, thumbnails are only
+// read once their row is painted, on a thread pool,
+// and the most recently shown ones are kept in memory
+class SaveStateModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+  public:
+    SaveStateModel(QObject *);
+    ~SaveStateModel(void);
+
+    void SetStates(QFileInfoList);
+    QString GetFile(const QModelIndex &);
+
+    int rowCount(const QModelIndex &) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &, int) const Q_DECL_OVERRIDE;
+
+  private:
+    QFileInfoList state_List;
+    QPixmap state_Placeholder;
+
+    mutable QCache<QString, QPixmap> thumbnail_Cache;
+    mutable QSet<QString> thumbnail_Pending;
+    mutable QThreadPool thumbnail_Pool;
+
+    QString thumbnail_Key(const QFileInfo &) const;
+    void thumbnail_Load(const QFileInfo &) const;
+
+  private slots:
+    void on_Thumbnail_Loaded(QString, QImage);
+};
+
+class SaveStateDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    SaveStateDialog(QWidget *);
+    ~SaveStateDialog(void);
+
+    QString GetSelectedFile(void);
+
+  private:
+    QListView *listView;
+    QDialogButtonBox *buttonBox;
+    SaveStateModel *model;
+    QString selectedFile;
+
+    void loadStates(void);
+
+  private slots:
+    void on_ListView_Activated(const QModelIndex &);
+    void accept(void) Q_DECL_OVERRIDE;
+};
+} // namespace Dialog
+} // namespace UserInterface
+
+#endif // SAVESTATEDIALOG_HPP
@@ -8,6 +8,7 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include "SettingsDialog.hpp"
+#include "../../Config.hpp"
 #include "../../Globals.hpp"
 #include "Utilities/SettingsID.hpp"
 
@@ -38,6 +39,10 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent, Qt::WindowSyst
     for (int i = 0; i < this->stackedWidget->count(); i++)
         this->reloadSettings(i);
 
+    // the plugin lists stay empty until the probe is done
+    if (!g_Plugins.IsProbeDone())
+        connect(&g_Plugins, &Utilities::Plugins::on_Plugins_Probed, this, &SettingsDialog::pluginsProbed);
+
     int width = g_Settings.GetIntValue(SettingsID::GUI_SettingsDialogWidth);
     int height = g_Settings.GetIntValue(SettingsID::GUI_SettingsDialogHeight);
 
@@ -167,17 +172,20 @@ void SettingsDialog::loadGameSettings(void)
 void SettingsDialog::loadGameCoreSettings(void)
 {
     bool overrideEnabled, randomizeInterrupt;
-    int cpuEmulator = 0;
+    int cpuEmulator = 0, runAheadFrames = 0;
 
     QString section = QString(this->gameInfo.Settings.MD5);
 
     overrideEnabled = g_Settings.GetBoolValue(SettingsID::Game_OverrideCoreSettings, section);
     cpuEmulator = g_Settings.GetIntValue(SettingsID::Game_CPU_Emulator, section);
     randomizeInterrupt = g_Settings.GetBoolValue(SettingsID::Game_RandomizeInterrupt, section);
+    runAheadFrames = g_Settings.GetIntValue(SettingsID::Game_RunAheadFrames, section);
 
     gameOverrideCoreSettingsGroupBox->setChecked(overrideEnabled);
     gameCoreCpuEmulatorComboBox->setCurrentIndex(cpuEmulator);
     gameRandomizeTimingCheckBox->setChecked(randomizeInterrupt);
+    gameRunAheadSpinBox->setMaximum(APP_RUNAHEAD_MAX_FRAMES);
+    gameRunAheadSpinBox->setValue(runAheadFrames);
 }
 
 void SettingsDialog::loadGamePluginSettings(void)
@@ -216,6 +224,9 @@ void SettingsDialog::loadPluginSettings(void)
     QString pluginFileName;
     int index = 0;
 
+    for (QComboBox *comboBox : comboBoxArray)
+        comboBox->clear();
+
     for (const Plugin_t &p : g_Plugins.GetAvailablePlugins())
     {
         comboBox = comboBoxArray[(int)p.Type];
@@ -261,33 +272,65 @@ void SettingsDialog::loadDirectorySettings(void)
 
 void SettingsDialog::loadKeybindSettings(void)
 {
-    KeyBindButton *buttons[] = {this->openRomKeyButton,   this->openComboKeyButton,      this->startEmuKeyButton,
-                                this->endEmuKeyButton,    this->refreshRomListKeyButton, this->exitKeyButton,
-
-                                this->softResetKeyButton, this->hardResetKeyButton,      this->generateBitmapKeyButton,
-                                this->limitFPSKeyButton,  this->swapDiskKeyButton,       this->saveStateKeyButton,
-                                this->saveAsKeyButton,    this->loadStateKeyButton,      this->loadKeyButton,
-                                this->cheatsKeyButton,    this->gsButtonKeyButton,       this->fullscreenKeyButton,
-                                this->settingsKeyButton};
+    KeyBindButton *buttons[] = {this->openRomKeyButton,       this->openComboKeyButton,      this->startEmuKeyButton,
+                                this->endEmuKeyButton,        this->refreshRomListKeyButton, this->exitKeyButton,
+
+                                this->softResetKeyButton,     this->hardResetKeyButton,      this->generateBitmapKeyButton,
+                                this->limitFPSKeyButton,      this->fastForwardKeyButton,    this->increaseSpeedKeyButton,
+                                this->decreaseSpeedKeyButton, this->rewindKeyButton,         this->swapDiskKeyButton,
+                                this->saveStateKeyButton,     this->saveAsKeyButton,         this->loadStateKeyButton,
+                                this->loadKeyButton,          this->cheatsKeyButton,         this->gsButtonKeyButton,
+                                this->fullscreenKeyButton,    this->settingsKeyButton};
+
+    // there's no button for every binding (Resume),
+    // so the ids can't be derived from the index
+    SettingsID ids[] = {SettingsID::KeyBinding_OpenROM,        SettingsID::KeyBinding_OpenCombo,
+                        SettingsID::KeyBinding_StartEmulation, SettingsID::KeyBinding_EndEmulation,
+                        SettingsID::KeyBinding_RefreshROMList, SettingsID::KeyBinding_Exit,
+
+                        SettingsID::KeyBinding_SoftReset,      SettingsID::KeyBinding_HardReset,
+                        SettingsID::KeyBinding_GenerateBitmap, SettingsID::KeyBinding_LimitFPS,
+                        SettingsID::KeyBinding_FastForward,    SettingsID::KeyBinding_IncreaseSpeed,
+                        SettingsID::KeyBinding_DecreaseSpeed,  SettingsID::KeyBinding_Rewind,
+                        SettingsID::KeyBinding_SwapDisk,       SettingsID::KeyBinding_SaveState,
+                        SettingsID::KeyBinding_SaveAs,         SettingsID::KeyBinding_LoadState,
+                        SettingsID::KeyBinding_Load,           SettingsID::KeyBinding_Cheats,
+                        SettingsID::KeyBinding_GSButton,       SettingsID::KeyBinding_Fullscreen,
+                        SettingsID::KeyBinding_Settings};
 
     SettingsID id;
     for (int i = 0; i < (sizeof(buttons) / sizeof(buttons[0])); i++)
     {
-        id = (SettingsID)(SettingsID::KeyBinding_OpenROM + i);
+        id = ids[i];
         buttons[i]->setText(g_Settings.GetStringValue(id));
     }
 }
 
 void SettingsDialog::loadBehaviorSettings(void)
 {
-    bool pause = false, resume = false;
-
-    /*
-        pause = g_Settings.GetBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss);
-        resume = g_Settings.GetBoolValue(SettingsID::GUI_ResumeEmulationOnFocus);
-    */
-
     this->manualResizingCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_AllowManualResizing));
+    this->offscreenRenderingCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_OffscreenRendering));
+    this->nativeRenderWindowCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_NativeRenderWindow));
+    this->nativeRenderFullscreenCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_NativeRenderFullscreen));
+    this->swapIntervalSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_SwapInterval));
+    this->matchRefreshRateCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_MatchRefreshRate));
+    this->scaleOnResizeCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_ScaleOnResize));
+    this->scaleFilterComboBox->setCurrentIndex(g_Settings.GetIntValue(SettingsID::GUI_ScaleFilter));
+    this->muteAudioWhenFastCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_MuteAudioWhenFast));
+    this->suspendOnExitCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_SuspendOnExit));
+    this->rewindGroupBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_RewindEnabled));
+    this->rewindBufferSizeSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_RewindBufferSize));
+    this->rewindIntervalSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_RewindInterval));
+    this->hangTimeoutSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_HangTimeout));
+    this->cpuAffinityLineEdit->setText(g_Settings.GetStringValue(SettingsID::GUI_CpuAffinity));
+    this->realtimePriorityCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_RealtimePriority));
+    this->niceSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_Nice));
+    this->lockMemoryCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_LockMemory));
+    this->demoteBackgroundCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_DemoteBackground));
+    this->idlePolicyComboBox->setCurrentIndex(g_Settings.GetIntValue(SettingsID::GUI_IdlePolicy));
+    this->idleSpeedSpinBox->setValue(g_Settings.GetIntValue(SettingsID::GUI_IdleSpeed));
+    this->idleOnFocusLossCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss));
+    this->resumeOnFocusCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_ResumeEmulationOnFocus));
 }
 
 void SettingsDialog::loadDefaultCoreSettings(void)
@@ -338,15 +381,17 @@ void SettingsDialog::loadDefaultGameSettings(void)
 void SettingsDialog::loadDefaultGameCoreSettings(void)
 {
     bool overrideEnabled, randomizeInterrupt;
-    int cpuEmulator = 0;
+    int cpuEmulator = 0, runAheadFrames = 0;
 
     overrideEnabled = g_Settings.GetDefaultBoolValue(SettingsID::Game_OverrideCoreSettings);
     cpuEmulator = g_Settings.GetDefaultIntValue(SettingsID::Game_CPU_Emulator);
     randomizeInterrupt = g_Settings.GetDefaultBoolValue(SettingsID::Game_RandomizeInterrupt);
+    runAheadFrames = g_Settings.GetDefaultIntValue(SettingsID::Game_RunAheadFrames);
 
     gameOverrideCoreSettingsGroupBox->setChecked(overrideEnabled);
     gameCoreCpuEmulatorComboBox->setCurrentIndex(cpuEmulator);
     gameRandomizeTimingCheckBox->setChecked(randomizeInterrupt);
+    gameRunAheadSpinBox->setValue(runAheadFrames);
 }
 
 void SettingsDialog::loadDefaultGamePluginSettings(void)
@@ -373,33 +418,67 @@ void SettingsDialog::loadDefaultDirectorySettings(void)
 
 void SettingsDialog::loadDefaultKeybindSettings(void)
 {
-    KeyBindButton *buttons[] = {this->openRomKeyButton,   this->openComboKeyButton,      this->startEmuKeyButton,
-                                this->endEmuKeyButton,    this->refreshRomListKeyButton, this->exitKeyButton,
-
-                                this->softResetKeyButton, this->hardResetKeyButton,      this->generateBitmapKeyButton,
-                                this->limitFPSKeyButton,  this->swapDiskKeyButton,       this->saveStateKeyButton,
-                                this->saveAsKeyButton,    this->loadStateKeyButton,      this->loadKeyButton,
-                                this->cheatsKeyButton,    this->gsButtonKeyButton,       this->fullscreenKeyButton,
-                                this->settingsKeyButton};
+    KeyBindButton *buttons[] = {this->openRomKeyButton,       this->openComboKeyButton,      this->startEmuKeyButton,
+                                this->endEmuKeyButton,        this->refreshRomListKeyButton, this->exitKeyButton,
+
+                                this->softResetKeyButton,     this->hardResetKeyButton,      this->generateBitmapKeyButton,
+                                this->limitFPSKeyButton,      this->fastForwardKeyButton,    this->increaseSpeedKeyButton,
+                                this->decreaseSpeedKeyButton, this->rewindKeyButton,         this->swapDiskKeyButton,
+                                this->saveStateKeyButton,     this->saveAsKeyButton,         this->loadStateKeyButton,
+                                this->loadKeyButton,          this->cheatsKeyButton,         this->gsButtonKeyButton,
+                                this->fullscreenKeyButton,    this->settingsKeyButton};
+
+    // there's no button for every binding (Resume),
+    // so the ids can't be derived from the index
+    SettingsID ids[] = {SettingsID::KeyBinding_OpenROM,        SettingsID::KeyBinding_OpenCombo,
+                        SettingsID::KeyBinding_StartEmulation, SettingsID::KeyBinding_EndEmulation,
+                        SettingsID::KeyBinding_RefreshROMList, SettingsID::KeyBinding_Exit,
+
+                        SettingsID::KeyBinding_SoftReset,      SettingsID::KeyBinding_HardReset,
+                        SettingsID::KeyBinding_GenerateBitmap, SettingsID::KeyBinding_LimitFPS,
+                        SettingsID::KeyBinding_FastForward,    SettingsID::KeyBinding_IncreaseSpeed,
+                        SettingsID::KeyBinding_DecreaseSpeed,  SettingsID::KeyBinding_Rewind,
+                        SettingsID::KeyBinding_SwapDisk,       SettingsID::KeyBinding_SaveState,
+                        SettingsID::KeyBinding_SaveAs,         SettingsID::KeyBinding_LoadState,
+                        SettingsID::KeyBinding_Load,           SettingsID::KeyBinding_Cheats,
+                        SettingsID::KeyBinding_GSButton,       SettingsID::KeyBinding_Fullscreen,
+                        SettingsID::KeyBinding_Settings};
 
     SettingsID id;
     for (int i = 0; i < (sizeof(buttons) / sizeof(buttons[0])); i++)
     {
-        id = (SettingsID)(SettingsID::KeyBinding_OpenROM + i);
+        id = ids[i];
         buttons[i]->setText(g_Settings.GetDefaultStringValue(id));
     }
 }
 
 void SettingsDialog::loadDefaultBehaviorSettings(void)
 {
-    bool pause = false, resume = false;
-
-    /*
-        pause = g_Settings.GetBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss);
-        resume = g_Settings.GetBoolValue(SettingsID::GUI_ResumeEmulationOnFocus);
-    */
-
     this->manualResizingCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_AllowManualResizing));
+    this->offscreenRenderingCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_OffscreenRendering));
+    this->nativeRenderWindowCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_NativeRenderWindow));
+    this->nativeRenderFullscreenCheckBox->setChecked(
+        g_Settings.GetDefaultBoolValue(SettingsID::GUI_NativeRenderFullscreen));
+    this->swapIntervalSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_SwapInterval));
+    this->matchRefreshRateCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_MatchRefreshRate));
+    this->scaleOnResizeCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_ScaleOnResize));
+    this->scaleFilterComboBox->setCurrentIndex(g_Settings.GetDefaultIntValue(SettingsID::GUI_ScaleFilter));
+    this->muteAudioWhenFastCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_MuteAudioWhenFast));
+    this->suspendOnExitCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_SuspendOnExit));
+    this->rewindGroupBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_RewindEnabled));
+    this->rewindBufferSizeSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_RewindBufferSize));
+    this->rewindIntervalSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_RewindInterval));
+    this->hangTimeoutSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_HangTimeout));
+    this->cpuAffinityLineEdit->setText(g_Settings.GetDefaultStringValue(SettingsID::GUI_CpuAffinity));
+    this->realtimePriorityCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_RealtimePriority));
+    this->niceSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_Nice));
+    this->lockMemoryCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_LockMemory));
+    this->demoteBackgroundCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_DemoteBackground));
+    this->idlePolicyComboBox->setCurrentIndex(g_Settings.GetDefaultIntValue(SettingsID::GUI_IdlePolicy));
+    this->idleSpeedSpinBox->setValue(g_Settings.GetDefaultIntValue(SettingsID::GUI_IdleSpeed));
+    this->idleOnFocusLossCheckBox->setChecked(
+        g_Settings.GetDefaultBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss));
+    this->resumeOnFocusCheckBox->setChecked(g_Settings.GetDefaultBoolValue(SettingsID::GUI_ResumeEmulationOnFocus));
 }
 
 void SettingsDialog::saveSettings(void)
@@ -471,16 +550,19 @@ void SettingsDialog::saveGameCoreSettings(void)
     bool overrideEnabled, randomizeInterrupt;
     bool defaultOverrideEnabled, defaultRandomizeInterrupt;
     int cpuEmulator = 0, defaultCpuEmulator;
+    int runAheadFrames = 0, defaultRunAheadFrames;
 
     QString section = QString(this->gameInfo.Settings.MD5);
 
     overrideEnabled = gameOverrideCoreSettingsGroupBox->isChecked();
     cpuEmulator = gameCoreCpuEmulatorComboBox->currentIndex();
     randomizeInterrupt = gameRandomizeTimingCheckBox->isChecked();
+    runAheadFrames = gameRunAheadSpinBox->value();
 
     defaultOverrideEnabled = g_Settings.GetDefaultBoolValue(SettingsID::Game_OverrideCoreSettings);
     defaultRandomizeInterrupt = g_Settings.GetDefaultBoolValue(SettingsID::Game_RandomizeInterrupt);
     defaultCpuEmulator = g_Settings.GetDefaultIntValue(SettingsID::Game_CPU_Emulator);
+    defaultRunAheadFrames = g_Settings.GetDefaultIntValue(SettingsID::Game_RunAheadFrames);
 
     if (defaultOverrideEnabled != overrideEnabled)
         g_Settings.SetValue(SettingsID::Game_OverrideCoreSettings, section, overrideEnabled);
@@ -488,6 +570,9 @@ void SettingsDialog::saveGameCoreSettings(void)
         g_Settings.SetValue(SettingsID::Game_CPU_Emulator, section, cpuEmulator);
     if (defaultRandomizeInterrupt != randomizeInterrupt)
         g_Settings.SetValue(SettingsID::Game_RandomizeInterrupt, section, randomizeInterrupt);
+    if (defaultRunAheadFrames != runAheadFrames ||
+        runAheadFrames != g_Settings.GetIntValue(SettingsID::Game_RunAheadFrames, section))
+        g_Settings.SetValue(SettingsID::Game_RunAheadFrames, section, runAheadFrames);
 }
 
 void SettingsDialog::saveGamePluginSettings(void)
@@ -538,33 +623,65 @@ void SettingsDialog::saveDirectorySettings(void)
 
 void SettingsDialog::saveKeybindSettings(void)
 {
-    KeyBindButton *buttons[] = {this->openRomKeyButton,   this->openComboKeyButton,      this->startEmuKeyButton,
-                                this->endEmuKeyButton,    this->refreshRomListKeyButton, this->exitKeyButton,
-
-                                this->softResetKeyButton, this->hardResetKeyButton,      this->generateBitmapKeyButton,
-                                this->limitFPSKeyButton,  this->swapDiskKeyButton,       this->saveStateKeyButton,
-                                this->saveAsKeyButton,    this->loadStateKeyButton,      this->loadKeyButton,
-                                this->cheatsKeyButton,    this->gsButtonKeyButton,       this->fullscreenKeyButton,
-                                this->settingsKeyButton};
+    KeyBindButton *buttons[] = {this->openRomKeyButton,       this->openComboKeyButton,      this->startEmuKeyButton,
+                                this->endEmuKeyButton,        this->refreshRomListKeyButton, this->exitKeyButton,
+
+                                this->softResetKeyButton,     this->hardResetKeyButton,      this->generateBitmapKeyButton,
+                                this->limitFPSKeyButton,      this->fastForwardKeyButton,    this->increaseSpeedKeyButton,
+                                this->decreaseSpeedKeyButton, this->rewindKeyButton,         this->swapDiskKeyButton,
+                                this->saveStateKeyButton,     this->saveAsKeyButton,         this->loadStateKeyButton,
+                                this->loadKeyButton,          this->cheatsKeyButton,         this->gsButtonKeyButton,
+                                this->fullscreenKeyButton,    this->settingsKeyButton};
+
+    // there's no button for every binding (Resume),
+    // so the ids can't be derived from the index
+    SettingsID ids[] = {SettingsID::KeyBinding_OpenROM,        SettingsID::KeyBinding_OpenCombo,
+                        SettingsID::KeyBinding_StartEmulation, SettingsID::KeyBinding_EndEmulation,
+                        SettingsID::KeyBinding_RefreshROMList, SettingsID::KeyBinding_Exit,
+
+                        SettingsID::KeyBinding_SoftReset,      SettingsID::KeyBinding_HardReset,
+                        SettingsID::KeyBinding_GenerateBitmap, SettingsID::KeyBinding_LimitFPS,
+                        SettingsID::KeyBinding_FastForward,    SettingsID::KeyBinding_IncreaseSpeed,
+                        SettingsID::KeyBinding_DecreaseSpeed,  SettingsID::KeyBinding_Rewind,
+                        SettingsID::KeyBinding_SwapDisk,       SettingsID::KeyBinding_SaveState,
+                        SettingsID::KeyBinding_SaveAs,         SettingsID::KeyBinding_LoadState,
+                        SettingsID::KeyBinding_Load,           SettingsID::KeyBinding_Cheats,
+                        SettingsID::KeyBinding_GSButton,       SettingsID::KeyBinding_Fullscreen,
+                        SettingsID::KeyBinding_Settings};
 
     SettingsID id;
     for (int i = 0; i < (sizeof(buttons) / sizeof(buttons[0])); i++)
     {
-        id = (SettingsID)(SettingsID::KeyBinding_OpenROM + i);
+        id = ids[i];
         g_Settings.SetValue(id, buttons[i]->text());
     }
 }
 
 void SettingsDialog::saveBehaviorSettings(void)
 {
-    bool pause = false, resume = false;
-
     g_Settings.SetValue(SettingsID::GUI_AllowManualResizing, this->manualResizingCheckBox->isChecked());
-    // this->manualResizingCheckBox->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_AllowManualResizing));
-    /* TODO for someday
-        g_Settings.SetValue(SettingsID::GUI_PauseEmulationOnFocusLoss, pause);
-        g_Settings.SetValue(SettingsID::GUI_ResumeEmulationOnFocus, resume);
-    */
+    g_Settings.SetValue(SettingsID::GUI_OffscreenRendering, this->offscreenRenderingCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_NativeRenderWindow, this->nativeRenderWindowCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_NativeRenderFullscreen, this->nativeRenderFullscreenCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_SwapInterval, this->swapIntervalSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_MatchRefreshRate, this->matchRefreshRateCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_ScaleOnResize, this->scaleOnResizeCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_ScaleFilter, this->scaleFilterComboBox->currentIndex());
+    g_Settings.SetValue(SettingsID::GUI_MuteAudioWhenFast, this->muteAudioWhenFastCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_SuspendOnExit, this->suspendOnExitCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_RewindEnabled, this->rewindGroupBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_RewindBufferSize, this->rewindBufferSizeSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_RewindInterval, this->rewindIntervalSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_HangTimeout, this->hangTimeoutSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_CpuAffinity, this->cpuAffinityLineEdit->text());
+    g_Settings.SetValue(SettingsID::GUI_RealtimePriority, this->realtimePriorityCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_Nice, this->niceSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_LockMemory, this->lockMemoryCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_DemoteBackground, this->demoteBackgroundCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_IdlePolicy, this->idlePolicyComboBox->currentIndex());
+    g_Settings.SetValue(SettingsID::GUI_IdleSpeed, this->idleSpeedSpinBox->value());
+    g_Settings.SetValue(SettingsID::GUI_PauseEmulationOnFocusLoss, this->idleOnFocusLossCheckBox->isChecked());
+    g_Settings.SetValue(SettingsID::GUI_ResumeEmulationOnFocus, this->resumeOnFocusCheckBox->isChecked());
 }
 
 void SettingsDialog::hideEmulationInfoText(void)
@@ -596,6 +713,14 @@ void SettingsDialog::chooseDirectory(QLineEdit *lineEdit)
     lineEdit->setText(dialog.directory().path());
 }
 
+void SettingsDialog::pluginsProbed(void)
+{
+    this->loadPluginSettings();
+
+    if (this->inGame)
+        this->loadGamePluginSettings();
+}
+
 void SettingsDialog::on_treeWidget_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous)
 {
     int topLevelCount = this->treeWidget->topLevelItemCount();
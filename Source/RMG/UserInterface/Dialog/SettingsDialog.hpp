@@ -71,6 +71,8 @@ class SettingsDialog : public QDialog, private Ui::SettingsDialog
     void chooseDirectory(QLineEdit *);
 
   private slots:
+    void pluginsProbed(void);
+
     void on_treeWidget_currentItemChanged(QTreeWidgetItem *, QTreeWidgetItem *);
     void on_buttonBox_clicked(QAbstractButton *);
 
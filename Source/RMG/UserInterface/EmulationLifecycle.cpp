@@ -0,0 +1,315 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "EmulationLifecycle.hpp"
+#include "../Config.hpp"
+#include "../Globals.hpp"
+#include "../Utilities/SettingsID.hpp"
+
+using namespace UserInterface;
+
+EmulationLifecycle::EmulationLifecycle(QObject *parent) : QObject(parent)
+{
+    this->watchdog_Timer.setSingleShot(true);
+    connect(&this->watchdog_Timer, &QTimer::timeout, this, &EmulationLifecycle::on_Watchdog_Timeout);
+    connect(&this->heartbeat_Timer, &QTimer::timeout, this, &EmulationLifecycle::on_Heartbeat_Timeout);
+}
+
+EmulationLifecycle::~EmulationLifecycle(void)
+{
+}
+
+void EmulationLifecycle::SetThread(Thread::EmulationThread *thread)
+{
+    this->emulationThread = thread;
+
+    connect(thread, &Thread::EmulationThread::on_Emulation_Finished, this,
+            &EmulationLifecycle::on_Emulation_Finished);
+    connect(thread, &Thread::EmulationThread::on_Emulation_CoreStateChanged, this,
+            &EmulationLifecycle::on_Emulation_CoreStateChanged);
+}
+
+EmulationState EmulationLifecycle::GetState(void)
+{
+    return this->lifecycle_State;
+}
+
+QString EmulationLifecycle::GetStateName(EmulationState state)
+{
+    switch (state)
+    {
+    case EmulationState::Idle:
+        return "Idle";
+    case EmulationState::Launching:
+        return "Launching";
+    case EmulationState::Running:
+        return "Running";
+    case EmulationState::Paused:
+        return "Paused";
+    case EmulationState::Stopping:
+        return "Stopping";
+    case EmulationState::Switching:
+        return "Switching";
+    }
+
+    return "Unknown";
+}
+
+bool EmulationLifecycle::IsActive(void)
+{
+    return this->lifecycle_State != EmulationState::Idle;
+}
+
+bool EmulationLifecycle::IsPaused(void)
+{
+    return this->lifecycle_State == EmulationState::Paused;
+}
+
+void EmulationLifecycle::Launch(QString file)
+{
+    switch (this->lifecycle_State)
+    {
+    case EmulationState::Idle:
+        this->lifecycle_Launch(file);
+        break;
+    case EmulationState::Launching:
+    case EmulationState::Running:
+    case EmulationState::Paused:
+        this->lifecycle_PendingFile = file;
+        this->lifecycle_Set(EmulationState::Switching);
+        this->lifecycle_Stop();
+        break;
+    case EmulationState::Stopping:
+    case EmulationState::Switching:
+        // already on its way out, the
+        // most recent request wins
+        this->lifecycle_PendingFile = file;
+        this->lifecycle_Set(EmulationState::Switching);
+        break;
+    }
+}
+
+void EmulationLifecycle::Stop(void)
+{
+    switch (this->lifecycle_State)
+    {
+    case EmulationState::Idle:
+        break;
+    case EmulationState::Launching:
+    case EmulationState::Running:
+    case EmulationState::Paused:
+        this->lifecycle_Set(EmulationState::Stopping);
+        this->lifecycle_Stop();
+        break;
+    case EmulationState::Stopping:
+    case EmulationState::Switching:
+        // asked again, after WaitForStop() the
+        // core might not have been told to stop
+        this->lifecycle_PendingFile.clear();
+        this->lifecycle_Set(EmulationState::Stopping);
+        this->lifecycle_Stop();
+        break;
+    }
+}
+
+void EmulationLifecycle::WaitForStop(void)
+{
+    if (this->lifecycle_State == EmulationState::Idle || this->lifecycle_State == EmulationState::Stopping ||
+        this->lifecycle_State == EmulationState::Switching)
+        return;
+
+    this->lifecycle_Set(EmulationState::Stopping);
+    this->watchdog_Start(APP_STOP_TIMEOUT);
+}
+
+bool EmulationLifecycle::Pause(void)
+{
+    if (this->lifecycle_State != EmulationState::Running || g_MupenApi.Core.isEmulationPaused())
+        return true;
+
+    return g_MupenApi.Core.PauseEmulation();
+}
+
+bool EmulationLifecycle::Resume(void)
+{
+    if (!this->IsActive() || !g_MupenApi.Core.isEmulationPaused())
+        return true;
+
+    return g_MupenApi.Core.ResumeEmulation();
+}
+
+bool EmulationLifecycle::TogglePause(void)
+{
+    if (g_MupenApi.Core.isEmulationPaused())
+        return this->Resume();
+
+    return this->Pause();
+}
+
+void EmulationLifecycle::lifecycle_Set(EmulationState state)
+{
+    EmulationState oldState = this->lifecycle_State;
+
+    if (oldState == state)
+        return;
+
+    this->lifecycle_State = state;
+
+    if (state == EmulationState::Running)
+        this->heartbeat_Start();
+    else
+        this->heartbeat_Timer.stop();
+
+    g_Logger.AddText("EmulationLifecycle: " + GetStateName(oldState) + " -> " + GetStateName(state));
+
+    emit this->on_Lifecycle_StateChanged(oldState, state);
+}
+
+void EmulationLifecycle::lifecycle_Launch(QString file)
+{
+    this->heartbeat_Timeout = g_Settings.GetIntValue(SettingsID::GUI_HangTimeout) * 1000;
+
+    this->lifecycle_Set(EmulationState::Launching);
+    this->watchdog_Start(APP_LAUNCH_TIMEOUT);
+
+    emit this->on_Lifecycle_Launch(file);
+}
+
+void EmulationLifecycle::lifecycle_Stop(void)
+{
+    this->watchdog_Start(APP_STOP_TIMEOUT);
+
+    // the core doesn't leave its pause loop to stop
+    if (g_MupenApi.Core.isEmulationPaused())
+        g_MupenApi.Core.ResumeEmulation();
+
+    // while launching the core might not run yet,
+    // on_Emulation_CoreStateChanged asks again once it does
+    if (!g_MupenApi.Core.StopEmulation())
+        g_Logger.AddText("EmulationLifecycle::lifecycle_Stop: " + g_MupenApi.Core.GetLastError());
+}
+
+void EmulationLifecycle::watchdog_Start(int timeout)
+{
+    this->watchdog_Timer.start(timeout);
+}
+
+void EmulationLifecycle::heartbeat_Start(void)
+{
+    if (this->heartbeat_Timeout <= 0)
+        return;
+
+    // a pause doesn't count towards the timeout
+    this->heartbeat_FrameCount = g_MupenApi.Core.GetFrameCount();
+    this->heartbeat_Time.start();
+    this->heartbeat_Reported = false;
+    this->heartbeat_Timer.start(1000);
+}
+
+void EmulationLifecycle::on_Emulation_Finished(bool ret)
+{
+    QString file = this->lifecycle_PendingFile;
+
+    // emitted at the very end of run(),
+    // so this returns right away
+    this->emulationThread->wait();
+
+    this->watchdog_Timer.stop();
+    this->lifecycle_PendingFile.clear();
+
+    if (this->lifecycle_State == EmulationState::Switching && !file.isEmpty())
+    {
+        this->lifecycle_Launch(file);
+        return;
+    }
+
+    this->lifecycle_Set(EmulationState::Idle);
+}
+
+void EmulationLifecycle::on_Emulation_CoreStateChanged(int value)
+{
+    switch (value)
+    {
+    case M64EMU_RUNNING:
+        if (this->lifecycle_State == EmulationState::Launching || this->lifecycle_State == EmulationState::Paused)
+        {
+            // the plugins have opened the ROM,
+            // whatever threads they need exist now
+            if (this->lifecycle_State == EmulationState::Launching)
+                this->emulationThread->SetSessionThreadAffinity();
+
+            this->watchdog_Timer.stop();
+            this->lifecycle_Set(EmulationState::Running);
+        }
+        else if (this->lifecycle_State == EmulationState::Stopping ||
+                 this->lifecycle_State == EmulationState::Switching)
+        {
+            // stop was requested before the core ran
+            if (!g_MupenApi.Core.StopEmulation())
+                g_Logger.AddText("EmulationLifecycle: " + g_MupenApi.Core.GetLastError());
+        }
+        break;
+    case M64EMU_PAUSED:
+        if (this->lifecycle_State == EmulationState::Launching || this->lifecycle_State == EmulationState::Running)
+        {
+            this->watchdog_Timer.stop();
+            this->lifecycle_Set(EmulationState::Paused);
+        }
+        break;
+    case M64EMU_STOPPED:
+        // stopped by the core itself, a frame limit or a suspend
+        if (this->lifecycle_State == EmulationState::Running || this->lifecycle_State == EmulationState::Paused)
+        {
+            this->lifecycle_Set(EmulationState::Stopping);
+            this->watchdog_Start(APP_STOP_TIMEOUT);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void EmulationLifecycle::on_Watchdog_Timeout(void)
+{
+    EmulationState state = this->lifecycle_State;
+
+    g_Logger.AddText("EmulationLifecycle: watchdog timed out while " + GetStateName(state));
+
+    emit this->on_Lifecycle_Timeout(state);
+
+    // a launch that hangs gets stopped, a hung stop is
+    // left to the user, who might have forced it by now
+    if (state == EmulationState::Launching && this->lifecycle_State == EmulationState::Launching)
+        this->Stop();
+}
+
+void EmulationLifecycle::on_Heartbeat_Timeout(void)
+{
+    quint64 frameCount = g_MupenApi.Core.GetFrameCount();
+
+    if (frameCount != this->heartbeat_FrameCount)
+    {
+        this->heartbeat_FrameCount = frameCount;
+        this->heartbeat_Time.restart();
+        this->heartbeat_Reported = false;
+        return;
+    }
+
+    // reported once per hang,
+    // until frames come again
+    if (this->heartbeat_Reported || this->heartbeat_Time.elapsed() < this->heartbeat_Timeout)
+        return;
+
+    this->heartbeat_Reported = true;
+
+    g_Logger.AddText("EmulationLifecycle: no frames for " + QString::number(this->heartbeat_Time.elapsed()) +
+                     "ms, at frame " + QString::number(frameCount));
+
+    emit this->on_Lifecycle_Timeout(EmulationState::Running);
+}
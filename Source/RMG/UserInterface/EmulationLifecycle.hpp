@@ -0,0 +1,102 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef EMULATIONLIFECYCLE_HPP
+#define EMULATIONLIFECYCLE_HPP
+
+#include "../Thread/EmulationThread.hpp"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+namespace UserInterface
+{
+enum class EmulationState
+{
+    Idle,
+    Launching,
+    Running,
+    Paused,
+    Stopping,
+    // stopping, with a ROM queued to launch after
+    Switching
+};
+
+// Keeps track of where emulation is, driven by the emulation
+// thread's signals and the core's state callback, so nothing
+// has to spin on the thread. Every state that waits on the
+// emulation thread is guarded by a watchdog, while running
+// that watchdog expects frames to keep coming
+class EmulationLifecycle : public QObject
+{
+    Q_OBJECT
+
+  public:
+    EmulationLifecycle(QObject *);
+    ~EmulationLifecycle(void);
+
+    void SetThread(Thread::EmulationThread *);
+
+    EmulationState GetState(void);
+    static QString GetStateName(EmulationState);
+    bool IsActive(void);
+    bool IsPaused(void);
+
+    // stops whatever runs first, the launch is queued
+    void Launch(QString);
+    void Stop(void);
+    // the core has been told to stop by someone else
+    void WaitForStop(void);
+
+    // the core pauses right away and reports
+    // it through its state callback
+    bool Pause(void);
+    bool Resume(void);
+    bool TogglePause(void);
+
+  private:
+    Thread::EmulationThread *emulationThread = nullptr;
+
+    EmulationState lifecycle_State = EmulationState::Idle;
+    QString lifecycle_PendingFile;
+
+    QTimer watchdog_Timer;
+
+    QTimer heartbeat_Timer;
+    QElapsedTimer heartbeat_Time;
+    quint64 heartbeat_FrameCount = 0;
+    int heartbeat_Timeout = 0;
+    bool heartbeat_Reported = false;
+
+    void lifecycle_Set(EmulationState);
+    void lifecycle_Launch(QString);
+    void lifecycle_Stop(void);
+
+    void watchdog_Start(int);
+
+    void heartbeat_Start(void);
+
+  private slots:
+    void on_Emulation_Finished(bool);
+    void on_Emulation_CoreStateChanged(int);
+    void on_Watchdog_Timeout(void);
+    void on_Heartbeat_Timeout(void);
+
+  signals:
+    void on_Lifecycle_StateChanged(UserInterface::EmulationState, UserInterface::EmulationState);
+    // MainWindow prepares the render widget and starts the thread
+    void on_Lifecycle_Launch(QString);
+    // Running when frames stopped coming
+    void on_Lifecycle_Timeout(UserInterface::EmulationState);
+};
+} // namespace UserInterface
+
+#endif // EMULATIONLIFECYCLE_HPP
@@ -14,8 +14,6 @@ EventFilter::~EventFilter(void)
 
 bool EventFilter::eventFilter(QObject *object, QEvent *event)
 {
-    static QObject *lastFocusObject = nullptr;
-
     switch (event->type())
     {
     case QEvent::Type::KeyPress:
@@ -24,17 +22,13 @@ bool EventFilter::eventFilter(QObject *object, QEvent *event)
     case QEvent::Type::KeyRelease:
         emit this->on_EventFilter_KeyReleased((QKeyEvent *)event);
         return true;
-    // it seems like Qt loses focus whenever you click on the menubar,
-    // even when re-implementing QMenuBar's focusIn/Out, it wont work correctly.
-    /*case QEvent::Type::FocusIn:
-        lastFocusObject = object;
-        std::cout << object << std::endl;
-        emit this->on_EventFilter_FocusIn((QFocusEvent *)event);
-        return true;
-    case QEvent::Type::FocusOut:
-        if (lastFocusObject == object)
-            emit this->on_EventFilter_FocusOut((QFocusEvent *)event);
-        return true;*/
+    // focus events are unreliable, Qt loses focus whenever
+    // the menubar is clicked, so window state and exposure
+    // decide whether anyone can see emulation instead
+    case QEvent::Type::Expose:
+    case QEvent::Type::WindowStateChange:
+        emit this->on_EventFilter_WindowChanged();
+        break;
     default:
         break;
     }
@@ -1,7 +1,6 @@
 #ifndef EVENTFILTER_HPP
 #define EVENTFILTER_HPP
 
-#include <QFocusEvent>
 #include <QKeyEvent>
 #include <QList>
 #include <QObject>
@@ -23,8 +22,8 @@ class EventFilter : public QObject
     void on_EventFilter_KeyPressed(QKeyEvent *);
     void on_EventFilter_KeyReleased(QKeyEvent *);
 
-    void on_EventFilter_FocusIn(QFocusEvent *);
-    void on_EventFilter_FocusOut(QFocusEvent *);
+    // exposed, hidden, minimized or restored
+    void on_EventFilter_WindowChanged(void);
 };
 } // namespace UserInterface
 
@@ -11,18 +11,32 @@
 #include "../Utilities/QtKeyToSdl2Key.hpp"
 #include "Config.hpp"
 #include "Globals.hpp"
+#include "M64P/Wrapper/VidExt.hpp"
 #include "UserInterface/EventFilter.hpp"
 
 #include <QCoreApplication>
 #include <QDesktopServices>
+#include <QDir>
+#include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QLocale>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QScreen>
 #include <QSettings>
 #include <QStatusBar>
 #include <QString>
+#include <QTimer>
 #include <QUrl>
 
+#include <cstdlib>
+
+// speed presets in percent, 0 is uncapped
+static const int speedPresets[] = {25, 50, 100, 200, 400, 0};
+
 using namespace UserInterface;
 using namespace M64P::Wrapper;
 
@@ -36,18 +50,39 @@ MainWindow::~MainWindow()
 
 bool MainWindow::Init(void)
 {
+    this->startup_Profiler.Start();
+
+    // read the stylesheet while we're loading the core
+    this->ui_Stylesheet = std::async(std::launch::async, []() -> QByteArray {
+        QFile stylesheet(APP_STYLESHEET_FILE);
+
+        if (!stylesheet.open(QIODevice::ReadOnly))
+            return QByteArray();
+
+        return stylesheet.readAll();
+    });
+
     if (!g_Logger.Init())
     {
         this->ui_MessageBox("Error", "Logger::Init Failed", g_Logger.GetLastError());
         return false;
     }
 
+    // only useful once something hangs,
+    // so a failure isn't worth stopping for
+    if (!this->ui_ThreadDump.Init())
+        g_Logger.AddText("MainWindow::Init: " + this->ui_ThreadDump.GetLastError());
+
+    this->startup_Profiler.AddPhase("Logger::Init");
+
     if (!g_MupenApi.Init(MUPEN_CORE_FILE))
     {
         this->ui_MessageBox("Error", "Api::Init Failed", g_MupenApi.GetLastError());
         return false;
     }
 
+    this->startup_Profiler.AddPhase("Api::Init");
+
     g_Settings.LoadDefaults();
 
     QString dataDir = g_Settings.GetStringValue(SettingsID::Core_UserDataDirOverride);
@@ -55,9 +90,13 @@ bool MainWindow::Init(void)
     if (g_Settings.GetBoolValue(SettingsID::Core_OverrideUserDirs))
         g_MupenApi.Config.OverrideUserPaths(dataDir, cacheDir);
 
+    this->startup_Profiler.AddPhase("Settings::LoadDefaults");
+
     this->ui_Init();
     this->ui_Setup();
 
+    this->startup_Profiler.AddPhase("MainWindow::ui_Init");
+
     this->menuBar_Init();
     this->menuBar_Setup(false, false);
 
@@ -66,22 +105,90 @@ bool MainWindow::Init(void)
 
     g_EmuThread = this->emulationThread;
 
+    this->startup_Profiler.AddPhase("MainWindow::menuBar_Init");
+
+    // runs once the window has been shown
+    QTimer::singleShot(0, this, &MainWindow::startup_Finish);
+
     return true;
 }
 
+void MainWindow::startup_Finish(void)
+{
+    this->startup_Profiler.AddPhase("MainWindow::show");
+
+    g_Logger.AddText("MainWindow::startup_Finish: time to interactive window: " +
+                     QString::number(this->startup_Profiler.GetElapsed()) + "ms");
+
+    // everything below isn't needed
+    // to show the first window
+    g_Plugins.LoadSettings();
+    g_MupenApi.Config.Save();
+
+    // keep Options -> Configure {type} Plugin... up-to-date
+    this->menuBar_Setup(false, false);
+
+    this->startup_Profiler.AddPhase("Plugins::LoadSettings (deferred)");
+
+    this->ui_Widget_RomBrowser->RefreshRomList();
+
+    this->startup_Profiler.AddPhase("RomBrowserWidget::RefreshRomList (deferred)");
+
+    this->ui_Resume_Setup();
+
+    g_Logger.AddText(this->startup_Profiler.GetReport("MainWindow::startup_Finish: startup report"));
+}
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     g_Settings.SetValue(SettingsID::GUI_RomBrowserGeometry,
                         QString(this->saveGeometry().toBase64().toStdString().c_str()));
 
-    this->on_Action_File_EndEmulation();
+    // emulation stops in the background, the
+    // window closes once the lifecycle is idle
+    if (this->emulationLifecycle->IsActive())
+    {
+        if (!this->ui_CloseRequested)
+        {
+            this->ui_CloseRequested = true;
+
+            // keep the session around for the next launch,
+            // suspending stops emulation once the state is saved
+            bool suspended = false;
+            EmulationState state = this->emulationLifecycle->GetState();
+            if ((state == EmulationState::Running || state == EmulationState::Paused) &&
+                g_Settings.GetBoolValue(SettingsID::GUI_SuspendOnExit))
+                suspended = this->ui_Suspend();
 
-    while (g_EmuThread->isRunning())
-        QCoreApplication::processEvents();
+            if (!suspended)
+                this->emulationLifecycle->Stop();
+
+            this->ui_CloseSuspended = suspended;
+        }
+        else
+        {
+            // closed again, the user is done waiting
+            this->ui_Close_Escalate();
+        }
+
+        event->ignore();
+        return;
+    }
+
+    // don't lose states still being written
+    g_MupenApi.Core.WaitForSaveStates();
 
     QMainWindow::closeEvent(event);
 }
 
+void MainWindow::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == this->ui_Stats_TimerId)
+        this->ui_Stats_Update();
+    else
+        QMainWindow::timerEvent(event);
+}
+
 #include <iostream>
 
 void MainWindow::ui_Init(void)
@@ -91,13 +198,19 @@ void MainWindow::ui_Init(void)
     this->ui_Widgets = new QStackedWidget(this);
     this->ui_Widget_RomBrowser = new Widget::RomBrowserWidget(this);
     this->ui_Widget_OpenGL = new Widget::OGLWidget(this);
+    this->ui_Widget_OpenGL_Native = new Widget::OGLWidget(this);
+    this->ui_Widget_FrameTimeGraph = new Widget::FrameTimeGraphWidget(this);
+    this->ui_Widget_FrameTimeGraph->SetStats(VidExt_GetFrameStats());
+    this->ui_Label_Stats = new QLabel(this);
+    this->ui_Resume_Button = new QPushButton(this);
     this->ui_EventFilter = new EventFilter(this);
 
     QString dir;
     dir = g_Settings.GetStringValue(SettingsID::GUI_RomBrowserDirectory);
 
+    // the ROM list gets filled after
+    // the window has been shown
     this->ui_Widget_RomBrowser->SetDirectory(dir);
-    this->ui_Widget_RomBrowser->RefreshRomList();
 
     connect(this->ui_Widget_RomBrowser, &Widget::RomBrowserWidget::on_RomBrowser_Select, this,
             &MainWindow::on_RomBrowser_Selected);
@@ -106,10 +219,18 @@ void MainWindow::ui_Init(void)
             &MainWindow::on_EventFilter_KeyPressed);
     connect(this->ui_EventFilter, &EventFilter::on_EventFilter_KeyReleased, this,
             &MainWindow::on_EventFilter_KeyReleased);
-    /*
-    connect(this->ui_EventFilter, &EventFilter::on_EventFilter_FocusIn, this, &MainWindow::on_EventFilter_FocusIn);
-    connect(this->ui_EventFilter, &EventFilter::on_EventFilter_FocusOut, this, &MainWindow::on_EventFilter_FocusOut);
-    */
+    connect(this->ui_EventFilter, &EventFilter::on_EventFilter_WindowChanged, this,
+            &MainWindow::on_EventFilter_WindowChanged);
+    connect(qApp, &QGuiApplication::applicationStateChanged, this, &MainWindow::on_Application_StateChanged);
+    connect(&g_Plugins, &Utilities::Plugins::on_Plugins_Probed, this, &MainWindow::on_Plugins_Probed);
+
+    // windows flicker out of view while switching
+    // to and from fullscreen, don't act on that
+    this->ui_Idle_Timer.setSingleShot(true);
+    connect(&this->ui_Idle_Timer, &QTimer::timeout, this, [this] {
+        if (this->ui_Idle_Check())
+            this->ui_Idle_Set(true);
+    });
 }
 
 void MainWindow::ui_Setup(void)
@@ -131,6 +252,11 @@ void MainWindow::ui_Setup(void)
     }
 
     this->statusBar()->setHidden(false);
+    this->statusBar()->addPermanentWidget(this->ui_Label_Stats);
+    this->statusBar()->addPermanentWidget(this->ui_Resume_Button);
+    this->ui_Resume_Button->setFlat(true);
+    this->ui_Resume_Button->hide();
+    connect(this->ui_Resume_Button, &QPushButton::clicked, this, &MainWindow::ui_Resume);
 
     this->ui_Widgets->addWidget(this->ui_Widget_RomBrowser);
     this->ui_Widgets->addWidget(this->ui_Widget_OpenGL->GetWidget());
@@ -140,16 +266,26 @@ void MainWindow::ui_Setup(void)
     this->setFocusPolicy(Qt::FocusPolicy::StrongFocus);
     this->installEventFilter(this->ui_EventFilter);
     this->ui_Widget_OpenGL->installEventFilter(this->ui_EventFilter);
+
+    // the native render window is a top-level window of its own,
+    // closing it ends emulation like the menu action does
+    this->ui_Widget_OpenGL_Native->setIcon(this->ui_Icon);
+    this->ui_Widget_OpenGL_Native->setTitle(WINDOW_TITLE);
+    this->ui_Widget_OpenGL_Native->installEventFilter(this->ui_EventFilter);
+    connect(this->ui_Widget_OpenGL_Native, &QWindow::visibleChanged, this, [this](bool visible) {
+        if (!visible && !this->ui_NativeClosing && this->emulationThread->isRunning())
+            this->on_Action_File_EndEmulation();
+    });
 }
 
 void MainWindow::ui_Stylesheet_Setup(void)
 {
-    QFile stylesheet(APP_STYLESHEET_FILE);
+    QByteArray stylesheet = this->ui_Stylesheet.get();
 
-    if (!stylesheet.open(QIODevice::ReadOnly))
+    if (stylesheet.isEmpty())
         return;
 
-    this->setStyleSheet(stylesheet.readAll());
+    this->setStyleSheet(stylesheet);
 }
 
 void MainWindow::ui_MessageBox(QString title, QString text, QString details = "")
@@ -179,7 +315,10 @@ void MainWindow::ui_InEmulation(bool inEmulation, bool isPaused)
         if (!QString(info.Settings.goodname).isEmpty())
             this->setWindowTitle(info.Settings.goodname + QString(" - ") + QString(WINDOW_TITLE));
 
-        this->ui_Widgets->setCurrentIndex(1);
+        // MainWindow only acts as a controller
+        // when rendering to the native window
+        if (g_OGLWidget != this->ui_Widget_OpenGL_Native)
+            this->ui_Widgets->setCurrentIndex(1);
     }
     else
     {
@@ -188,6 +327,564 @@ void MainWindow::ui_InEmulation(bool inEmulation, bool isPaused)
     }
 }
 
+void MainWindow::ui_FrameTimeGraph_Start(void)
+{
+    this->ui_Widget_FrameTimeGraph->SetWindow(g_OGLWidget);
+    this->ui_Widget_FrameTimeGraph->Start();
+}
+
+void MainWindow::ui_Stats_Start(void)
+{
+    RomInfo_t info = {0};
+    double viRate = 60.0;
+
+    if (g_MupenApi.Core.GetRomInfo(&info))
+        viRate = g_MupenApi.Core.GetRomViRate(&info);
+
+    // run-ahead emulates every shown frame again,
+    // so 100% speed means the machine keeps up with it
+    this->ui_Stats.Reset(viRate * (g_MupenApi.Core.GetRunAheadFrames() + 1));
+    this->ui_Stats_Update();
+
+    if (g_Settings.GetBoolValue(SettingsID::GUI_ShowStatsOverlay))
+    {
+        Widget::OGLTextOverlay *overlay = g_OGLWidget->GetTextOverlay();
+        if (overlay->Init(MUPEN_DATA_DIR "/font.ttf", 16))
+            overlay->SetEnabled(true);
+        else
+            g_Logger.AddText(overlay->GetLastError());
+    }
+
+    if (this->ui_Stats_TimerId == 0)
+        this->ui_Stats_TimerId = this->startTimer(500);
+}
+
+void MainWindow::ui_Stats_Stop(void)
+{
+    if (this->ui_Stats_TimerId != 0)
+    {
+        this->killTimer(this->ui_Stats_TimerId);
+        this->ui_Stats_TimerId = 0;
+    }
+
+    this->ui_Widget_OpenGL->GetTextOverlay()->SetEnabled(false);
+    this->ui_Widget_OpenGL_Native->GetTextOverlay()->SetEnabled(false);
+    this->ui_Label_Stats->clear();
+}
+
+void MainWindow::ui_Stats_Update(void)
+{
+    this->ui_Stats.Sample(g_MupenApi.Core.GetFrameCount(), VidExt_GetFrameStats()->GetFrameCount(),
+                          g_MupenApi.Core.GetCpuTime());
+
+    QString summary = this->ui_Stats.GetSummary();
+    g_OGLWidget->GetTextOverlay()->SetText(summary);
+
+    // how much history there is and what it costs
+    if (g_Settings.GetBoolValue(SettingsID::GUI_RewindEnabled))
+    {
+        Utilities::RewindBuffer *rewind = g_MupenApi.Core.GetRewindBuffer();
+        double seconds = rewind->GetCount() * g_MupenApi.Core.GetRewindInterval() / this->ui_Stats.GetTargetRate();
+
+        summary += "  Rewind " + QString::number(seconds, 'f', 0) + "s ";
+        summary += QString::number(rewind->GetSize() / (1024.0 * 1024.0), 'f', 1) + "MB ";
+        summary += QString::number(rewind->GetEncodeTime(), 'f', 1) + "ms";
+    }
+
+    // the cpu usage doesn't show the savestate
+    // round trip every shown frame takes
+    if (g_MupenApi.Core.GetRunAheadFrames() > 0)
+    {
+        summary += "  Run-ahead " + QString::number(g_MupenApi.Core.GetRunAheadFrames()) + "f ";
+        summary += QString::number(g_MupenApi.Core.GetRunAheadStateTime(), 'f', 1) + "ms";
+    }
+
+    this->ui_Label_Stats->setText(summary);
+}
+
+void MainWindow::ui_Speed_Set(int speed)
+{
+    this->ui_Speed = speed;
+    this->ui_Speed_Apply();
+
+    if (!this->ui_Speed_FastForward)
+        this->statusBar()->showMessage("Speed: " + this->ui_Speed_Text(speed), 3000);
+}
+
+void MainWindow::ui_Speed_Step(int step)
+{
+    int count = sizeof(speedPresets) / sizeof(speedPresets[0]);
+    int index = 0;
+
+    // when the current speed isn't a preset,
+    // step from the closest one below it
+    for (int i = 0; i < count; i++)
+    {
+        if (speedPresets[i] != 0 && speedPresets[i] <= this->ui_Speed)
+            index = i;
+    }
+    if (this->ui_Speed == 0)
+        index = count - 1;
+
+    index = qBound(0, index + step, count - 1);
+
+    this->ui_Speed_Set(speedPresets[index]);
+}
+
+void MainWindow::ui_Speed_Apply(void)
+{
+    int speed = this->ui_Speed_FastForward ? APP_FASTFORWARD_SPEED : this->ui_Speed;
+    bool idle = this->ui_Idle && this->ui_Idle_Policy == IdlePolicy::ReduceSpeed;
+    bool muted, ret;
+
+    // nobody's watching, the game only has to keep going
+    if (idle)
+    {
+        int idleSpeed = g_Settings.GetIntValue(SettingsID::GUI_IdleSpeed);
+        speed = speed == 0 ? idleSpeed : qMin(speed, idleSpeed);
+    }
+
+    if (speed == 0)
+        ret = g_MupenApi.Core.DisableSpeedLimiter();
+    else
+        ret = g_MupenApi.Core.SetSpeedFactor(speed) && g_MupenApi.Core.EnableSpeedLimiter();
+
+    // the audio plugin can't keep up above full speed,
+    // silence beats a stream of underruns
+    muted = (speed == 0 || speed > 100) && g_Settings.GetBoolValue(SettingsID::GUI_MuteAudioWhenFast);
+    muted = muted || idle;
+    if (ret)
+        ret = g_MupenApi.Core.SetAudioMuted(muted);
+
+    if (!ret)
+        this->ui_MessageBox("Error", "Api::Core::SetSpeedFactor Failed", g_MupenApi.Core.GetLastError());
+
+    this->action_System_LimitFPS->setChecked(this->ui_Speed != 0);
+    for (QAction *action : this->menu_System_Speed->actions())
+    {
+        if (action->isCheckable())
+            action->setChecked(action->data().toInt() == this->ui_Speed);
+    }
+}
+
+bool MainWindow::ui_Idle_Check(void)
+{
+    EmulationState state = this->emulationLifecycle->GetState();
+    bool minimized, unfocused;
+
+    if ((IdlePolicy)g_Settings.GetIntValue(SettingsID::GUI_IdlePolicy) == IdlePolicy::None ||
+        (state != EmulationState::Running && state != EmulationState::Paused))
+        return false;
+
+    if (g_OGLWidget == this->ui_Widget_OpenGL_Native)
+        minimized = this->ui_Widget_OpenGL_Native->windowState() == Qt::WindowMinimized;
+    else
+        minimized = this->isMinimized();
+
+    unfocused = QGuiApplication::applicationState() != Qt::ApplicationActive &&
+                g_Settings.GetBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss);
+
+    // an unexposed window is hidden or, where the
+    // window system reports it, fully covered
+    return minimized || unfocused || !g_OGLWidget->isExposed();
+}
+
+void MainWindow::ui_Idle_Update(void)
+{
+    bool idle = this->ui_Idle_Check();
+
+    if (!idle)
+    {
+        this->ui_Idle_Timer.stop();
+        if (this->ui_Idle)
+            this->ui_Idle_Set(false);
+        return;
+    }
+
+    if (!this->ui_Idle && !this->ui_Idle_Timer.isActive())
+        this->ui_Idle_Timer.start(APP_IDLE_SETTLE_TIME);
+}
+
+void MainWindow::ui_Idle_Set(bool idle)
+{
+    if (idle == this->ui_Idle)
+        return;
+
+    // the policy in effect when going idle
+    // is the one that has to be undone
+    if (idle)
+        this->ui_Idle_Policy = (IdlePolicy)g_Settings.GetIntValue(SettingsID::GUI_IdlePolicy);
+
+    this->ui_Idle = idle;
+
+    g_Logger.AddText(QString("MainWindow::ui_Idle_Set: ") + (idle ? "idle" : "active") + ", policy " +
+                     QString::number((int)this->ui_Idle_Policy));
+
+    switch (this->ui_Idle_Policy)
+    {
+    case IdlePolicy::Pause:
+        if (idle)
+        {
+            // a game paused by the user stays
+            // paused, whatever the setting says
+            this->ui_Idle_Paused = !g_MupenApi.Core.isEmulationPaused() && this->emulationLifecycle->Pause();
+        }
+        else if (this->ui_Idle_Paused)
+        {
+            this->ui_Idle_Paused = false;
+            if (g_Settings.GetBoolValue(SettingsID::GUI_ResumeEmulationOnFocus))
+                this->emulationLifecycle->Resume();
+        }
+        break;
+    case IdlePolicy::SkipPresent:
+        g_MupenApi.Core.SetPresentationSkipped(idle);
+        break;
+    case IdlePolicy::ReduceSpeed:
+        this->ui_Speed_Apply();
+        break;
+    default:
+        break;
+    }
+}
+
+void MainWindow::ui_Rewind_Set(bool enabled)
+{
+    if (enabled == this->ui_Rewind || !g_Settings.GetBoolValue(SettingsID::GUI_RewindEnabled))
+        return;
+
+    this->ui_Rewind = enabled;
+    g_MupenApi.Core.SetRewindActive(enabled);
+
+    // snapshots play back in chunks,
+    // which sounds worse than nothing
+    if (enabled)
+    {
+        g_MupenApi.Core.SetAudioMuted(true);
+        this->statusBar()->showMessage("Rewinding...");
+    }
+    else
+    {
+        this->ui_Speed_Apply();
+        this->statusBar()->clearMessage();
+    }
+}
+
+QString MainWindow::ui_Suspend_File(void)
+{
+    return QDir(g_Settings.GetStringValue(SettingsID::Core_SaveStatePath)).filePath(APP_SUSPEND_FILE);
+}
+
+bool MainWindow::ui_Suspend(void)
+{
+    QString file = this->ui_Suspend_File();
+    RomInfo_t info = {0};
+    QString romFile;
+    Plugin_t plugin;
+
+    // only the info of the launched ROM has its file name
+    if (!g_MupenApi.Core.GetDefaultRomInfo(&info))
+        return false;
+
+    romFile = QFileInfo(info.FileName).absoluteFilePath();
+
+    // an older state must not pass for this session,
+    // should saving it fail
+    this->ui_Suspend_Clear();
+
+    QSettings suspendInfo(file + ".ini", QSettings::IniFormat);
+    suspendInfo.setValue("Rom", romFile);
+    suspendInfo.setValue("GoodName", QString(info.Settings.goodname));
+    suspendInfo.setValue("MD5", QString(info.Settings.MD5));
+    for (int i = 0; i < 4; i++)
+    {
+        if (g_MupenApi.Core.GetCurrentPlugin((PluginType)i, &plugin))
+            suspendInfo.setValue("Plugins/" + QString::number(i), plugin.Name);
+    }
+    suspendInfo.sync();
+
+    // without a ROM to go back to, the
+    // state is of no use to ui_Resume_Setup
+    if (info.FileName.isEmpty() || suspendInfo.status() != QSettings::NoError ||
+        !QFile::exists(QSettings(file + ".ini", QSettings::IniFormat).value("Rom").toString()))
+    {
+        g_Logger.AddText("MainWindow::ui_Suspend: failed to store the ROM file: " + romFile);
+        this->ui_Suspend_Clear();
+        return false;
+    }
+
+    // compressing and writing happens on the
+    // savestate thread, closeEvent waits for it
+    if (!g_MupenApi.Core.SuspendEmulation(file))
+    {
+        g_Logger.AddText("MainWindow::ui_Suspend: " + g_MupenApi.Core.GetLastError());
+        this->ui_Suspend_Clear();
+        return false;
+    }
+
+    this->emulationLifecycle->WaitForStop();
+    return true;
+}
+
+void MainWindow::ui_Suspend_Clear(void)
+{
+    QString file = this->ui_Suspend_File();
+
+    QFile::remove(file);
+    QFile::remove(file + ".png");
+    QFile::remove(file + ".ini");
+}
+
+void MainWindow::ui_Resume_Setup(void)
+{
+    QString file = this->ui_Suspend_File();
+
+    this->ui_Resume_Button->hide();
+
+    if (!QFile::exists(file) || !QFile::exists(file + ".ini"))
+        return;
+
+    QSettings suspendInfo(file + ".ini", QSettings::IniFormat);
+    QString romFile = suspendInfo.value("Rom").toString();
+
+    if (!QFile::exists(romFile))
+        return;
+
+    this->ui_Resume_Button->setText("Resume " + suspendInfo.value("GoodName").toString());
+    this->ui_Resume_Button->setToolTip("Suspended " +
+                                       QLocale().toString(QFileInfo(file).lastModified(), QLocale::ShortFormat));
+    this->ui_Resume_Button->setIcon(QIcon(file + ".png"));
+    this->ui_Resume_Button->setIconSize(QSize(48, 36));
+    this->ui_Resume_Button->show();
+}
+
+void MainWindow::ui_Resume(void)
+{
+    QString file = this->ui_Suspend_File();
+    QSettings suspendInfo(file + ".ini", QSettings::IniFormat);
+    QString romFile = suspendInfo.value("Rom").toString();
+    RomInfo_t info = {0};
+
+    this->ui_Resume_Button->hide();
+    this->ui_Resume_Timer.start();
+    this->ui_Resume_StartupTime = 0;
+
+    // the state only fits the exact same ROM
+    if (!g_MupenApi.Core.GetRomInfo(romFile, &info, true) ||
+        QString(info.Settings.MD5) != suspendInfo.value("MD5").toString())
+    {
+        this->ui_Resume_Timer.invalidate();
+        this->ui_MessageBox("Error", "Can't resume, the ROM is missing or has changed", romFile);
+        this->ui_Suspend_Clear();
+        return;
+    }
+
+    // loaded on the first frame, frames are
+    // hidden until then so the boot isn't shown
+    g_MupenApi.Core.SetResumeState(file);
+    this->emulationThread_Launch(romFile);
+}
+
+QString MainWindow::ui_HangReport(EmulationState state)
+{
+    QString report;
+    RomInfo_t info = {0};
+    Plugin_t plugin;
+    quint32 pc;
+
+    report = "State: " + EmulationLifecycle::GetStateName(state) + "\n";
+
+    if (g_MupenApi.Core.GetRomInfo(&info))
+        report += "ROM: " + QString(info.Settings.goodname) + " (" + QString(info.Settings.MD5) + ")\n";
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (g_MupenApi.Core.GetCurrentPlugin((PluginType)i, &plugin))
+            report += "Plugin: " + plugin.Name + " (" + plugin.FileName + ")\n";
+    }
+
+    report += "Frame: " + QString::number(g_MupenApi.Core.GetFrameCount()) + "\n";
+
+    // where the emulated CPU is, which tells
+    // a plugin hang apart from a game bug
+    if (g_MupenApi.Core.GetProgramCounter(&pc))
+        report += "PC: 0x" + QString::number(pc, 16).rightJustified(8, '0') + "\n";
+    else
+        report += g_MupenApi.Core.GetLastError() + "\n";
+
+    report += "\nLast messages:\n";
+    for (const QString &message : g_MupenApi.Core.GetDebugMessages())
+        report += "  " + message + "\n";
+
+    report += "\nThreads:\n";
+    if (this->ui_ThreadDump.Capture())
+        report += this->ui_ThreadDump.GetReport();
+    else
+        report += this->ui_ThreadDump.GetLastError() + "\n";
+
+    return report;
+}
+
+void MainWindow::ui_ForceQuit(void)
+{
+    g_Logger.AddText("MainWindow::ui_ForceQuit: emulation is hung, forcing shutdown");
+
+    g_Settings.SetValue(SettingsID::GUI_RomBrowserGeometry,
+                        QString(this->saveGeometry().toBase64().toStdString().c_str()));
+    g_MupenApi.Config.Save();
+
+    // written on their own thread,
+    // the hung one isn't needed for that
+    g_MupenApi.Core.WaitForSaveStates();
+
+    // a normal exit would wait on the
+    // emulation thread, skip it entirely
+    std::_Exit(EXIT_FAILURE);
+}
+
+void MainWindow::ui_Close_Escalate(void)
+{
+    // stopping doesn't need the frames
+    // saving the state was waiting on
+    if (this->ui_CloseSuspended)
+    {
+        g_Logger.AddText("MainWindow::ui_Close_Escalate: suspend didn't finish, stopping instead");
+        this->ui_CloseSuspended = false;
+        this->ui_Suspend_Clear();
+        this->emulationLifecycle->Stop();
+        return;
+    }
+
+    // the same choice a hang gets
+    this->on_Lifecycle_Timeout(this->emulationLifecycle->GetState());
+}
+
+QString MainWindow::ui_Speed_Text(int speed)
+{
+    if (speed == 0)
+        return "Uncapped";
+
+    return QString::number(speed) + "%";
+}
+
+void MainWindow::ui_Native_Show(void)
+{
+    if (this->ui_SwapInterval >= 0)
+    {
+        QSurfaceFormat format = this->ui_Widget_OpenGL_Native->requestedFormat();
+        format.setSwapInterval(this->ui_SwapInterval);
+        this->ui_Widget_OpenGL_Native->setFormat(format);
+    }
+
+    this->ui_NativeClosing = false;
+
+    if (this->ui_NativeFullscreen)
+        this->ui_FullScreen_Setup(true);
+    else
+        this->ui_Widget_OpenGL_Native->showNormal();
+
+    this->ui_Widget_OpenGL_Native->requestActivate();
+    this->ui_Widget_OpenGL_Native->update();
+}
+
+void MainWindow::ui_Native_Hide(void)
+{
+    this->ui_NativeClosing = true;
+    this->ui_Widget_OpenGL_Native->hide();
+    this->ui_NativeClosing = false;
+    this->ui_FullScreen = false;
+}
+
+void MainWindow::ui_FullScreen_Setup(bool fullscreen)
+{
+    bool native = g_OGLWidget == this->ui_Widget_OpenGL_Native;
+
+    if (fullscreen)
+    {
+        QScreen *screen = nullptr;
+
+        if (g_Settings.GetBoolValue(SettingsID::GUI_MatchRefreshRate))
+            screen = this->ui_FullScreen_FindScreen();
+
+        if (native)
+        {
+            if (screen != nullptr)
+            {
+                g_OGLWidget->setScreen(screen);
+                g_OGLWidget->setPosition(screen->geometry().topLeft());
+            }
+
+            g_OGLWidget->showFullScreen();
+        }
+        else
+        {
+            if (screen != nullptr)
+            {
+                this->move(screen->geometry().topLeft());
+                this->windowHandle()->setScreen(screen);
+            }
+
+            // the window may have a fixed size
+            this->setMinimumSize(0, 0);
+            this->setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+            this->menuBar->hide();
+            this->statusBar()->hide();
+            this->showFullScreen();
+        }
+    }
+    else
+    {
+        if (native)
+        {
+            g_OGLWidget->showNormal();
+        }
+        else
+        {
+            this->menuBar->show();
+            this->statusBar()->show();
+            this->showNormal();
+
+            if (!this->ui_VideoSize.isEmpty())
+                this->on_VidExt_ResizeWindow(this->ui_VideoSize.width(), this->ui_VideoSize.height());
+        }
+    }
+
+    this->ui_FullScreen = fullscreen;
+}
+
+QScreen *MainWindow::ui_FullScreen_FindScreen(void)
+{
+    RomInfo_t info = {0};
+    double viRate = 60.0;
+    QScreen *bestScreen = nullptr;
+    double bestError = 0;
+
+    if (g_MupenApi.Core.GetRomInfo(&info))
+        viRate = g_MupenApi.Core.GetRomViRate(&info);
+
+    // a refresh rate that's a multiple of the VI rate
+    // won't judder, prefer the closest one of those
+    for (QScreen *screen : QGuiApplication::screens())
+    {
+        double rate = screen->refreshRate();
+        double multiple = qMax(1.0, qRound(rate / viRate) * 1.0);
+        double error = qAbs(rate - (multiple * viRate));
+
+        if (bestScreen == nullptr || error < bestError)
+        {
+            bestScreen = screen;
+            bestError = error;
+        }
+    }
+
+    if (bestScreen != nullptr)
+    {
+        g_Logger.AddText("MainWindow::ui_FullScreen_FindScreen: " + QString::number(viRate) + "Hz game, using " +
+                         bestScreen->name() + " at " + QString::number(bestScreen->refreshRate()) + "Hz");
+    }
+
+    return bestScreen;
+}
+
 void MainWindow::ui_SaveGeometry(void)
 {
     if (this->ui_Geometry_Saved)
@@ -267,6 +964,7 @@ void MainWindow::menuBar_Setup(bool inEmulation, bool isPaused)
         this->menuBar_Menu->addAction(this->action_System_GenerateBitmap);
         this->menuBar_Menu->addSeparator();
         this->menuBar_Menu->addAction(this->action_System_LimitFPS);
+        this->menuBar_Menu->addMenu(this->menu_System_Speed);
         this->menuBar_Menu->addSeparator();
         this->menuBar_Menu->addAction(this->action_System_SwapDisk);
         this->menuBar_Menu->addSeparator();
@@ -274,42 +972,98 @@ void MainWindow::menuBar_Setup(bool inEmulation, bool isPaused)
         this->menuBar_Menu->addAction(this->action_System_SaveAs);
         this->menuBar_Menu->addAction(this->action_System_LoadState);
         this->menuBar_Menu->addAction(this->action_System_Load);
+        this->menuBar_Menu->addAction(this->action_System_SaveStates);
         this->menuBar_Menu->addSeparator();
         this->menuBar_Menu->addMenu(this->menu_System_CurrentSaveState);
 
         this->menu_System_CurrentSaveState->clear();
 
-        QActionGroup *slotActionGroup = new QActionGroup(this);
-        QList<QAction *> slotActions;
+        // the actions are owned by the menu, so clear()
+        // deletes them, which takes them out of the group
         QAction *slotAction;
+        QFileInfo slotInfo;
         for (int i = 0; i < 10; i++)
         {
-            slotActions.append(new QAction(this));
-            slotAction = slotActions.at(i);
-
-            slotAction->setText("Slot " + QString::number(i + 1));
+            slotAction = this->menu_System_CurrentSaveState->addAction("Slot " + QString::number(i + 1));
+            slotInfo = QFileInfo(g_MupenApi.Core.GetSaveStateFile(i));
+
+            if (slotInfo.exists())
+            {
+                slotAction->setText(slotAction->text() + " - " +
+                                    QLocale().toString(slotInfo.lastModified(), QLocale::ShortFormat));
+                // QIcon only reads the file once the menu is shown
+                slotAction->setIcon(QIcon(slotInfo.absoluteFilePath() + ".png"));
+            }
             slotAction->setCheckable(true);
-            slotAction->setChecked(i == 0);
-            slotAction->setActionGroup(slotActionGroup);
+            slotAction->setChecked(i == g_MupenApi.Core.GetSaveSlot());
+            slotAction->setActionGroup(this->group_System_CurrentSaveState);
 
             connect(slotAction, &QAction::triggered, [=](bool checked) {
                 if (checked)
                 {
-                    int slot = slotAction->text().split(" ").last().toInt() - 1;
-                    this->on_Action_System_CurrentSaveState(slot);
+                    this->on_Action_System_CurrentSaveState(i);
                 }
             });
+        }
 
-            this->menu_System_CurrentSaveState->addAction(slotAction);
+        this->menu_System_Speed->clear();
+
+        QAction *speedAction;
+        for (int speed : speedPresets)
+        {
+            speedAction = this->menu_System_Speed->addAction(this->ui_Speed_Text(speed));
+            speedAction->setData(speed);
+            speedAction->setCheckable(true);
+            speedAction->setChecked(speed == this->ui_Speed);
+            speedAction->setActionGroup(this->group_System_Speed);
+
+            connect(speedAction, &QAction::triggered, [=](bool checked) {
+                if (checked)
+                    this->ui_Speed_Set(speed);
+            });
         }
+        this->menu_System_Speed->addSeparator();
+        this->menu_System_Speed->addAction(this->action_System_IncreaseSpeed);
+        this->menu_System_Speed->addAction(this->action_System_DecreaseSpeed);
 
         this->menuBar_Menu->addSeparator();
         this->menuBar_Menu->addAction(this->action_System_Cheats);
         this->menuBar_Menu->addAction(this->action_System_GSButton);
+        this->menuBar_Menu->addSeparator();
+        this->menuBar_Menu->addMenu(this->menu_System_SwapPlugin);
+
+        // clear() leaves the submenus alive, their
+        // actions and groups go along with them
+        qDeleteAll(this->menu_System_SwapPlugin->findChildren<QMenu *>(QString(), Qt::FindDirectChildrenOnly));
+        this->menu_System_SwapPlugin->clear();
+
+        QString pluginTypeNames[] = {"Graphics", "Audio", "Input", "RSP"};
+        for (int i = 0; i < 4; i++)
+        {
+            QMenu *pluginMenu = this->menu_System_SwapPlugin->addMenu(pluginTypeNames[i]);
+            QActionGroup *pluginActionGroup = new QActionGroup(pluginMenu);
+            Plugin_t currentPlugin = g_Plugins.GetCurrentPlugin((PluginType)i);
+            QAction *pluginAction;
+
+            for (const Plugin_t &p : g_Plugins.GetAvailablePlugins((PluginType)i))
+            {
+                pluginAction = pluginMenu->addAction(p.Name);
+                pluginAction->setCheckable(true);
+                pluginAction->setChecked(p.FileName == currentPlugin.FileName);
+                pluginAction->setActionGroup(pluginActionGroup);
+
+                connect(pluginAction, &QAction::triggered, [=](bool checked) {
+                    if (checked)
+                        this->on_Action_System_SwapPlugin(p);
+                });
+            }
+        }
     }
 
     this->menuBar_Menu = this->menuBar->addMenu("Options");
     this->menuBar_Menu->addAction(this->action_Options_FullScreen);
+    this->menuBar_Menu->addAction(this->action_Options_FrameTimeGraph);
+    this->menuBar_Menu->addAction(this->action_Options_StatsOverlay);
     this->menuBar_Menu->addSeparator();
     this->menuBar_Menu->addAction(this->action_Options_ConfigGfx);
     this->menuBar_Menu->addAction(this->action_Options_ConfigAudio);
@@ -325,11 +1079,28 @@ void MainWindow::menuBar_Setup(bool inEmulation, bool isPaused)
     this->menuBar_Menu->addAction(this->action_Help_About);
 
     this->setMenuBar(menuBar);
+
+    // the menubar is hidden in fullscreen, so the window holds
+    // the menu actions as well to keep their shortcuts working
+    for (QAction *action : this->actions())
+        this->removeAction(action);
+
+    for (QAction *menuAction : this->menuBar->actions())
+    {
+        for (QAction *action : menuAction->menu()->actions())
+        {
+            if (action->menu() != nullptr)
+                this->addActions(action->menu()->actions());
+            else if (!action->isSeparator())
+                this->addAction(action);
+        }
+    }
 }
 
 void MainWindow::emulationThread_Init(void)
 {
     this->emulationThread = new Thread::EmulationThread();
+    this->emulationLifecycle = new EmulationLifecycle(this);
 }
 
 void MainWindow::emulationThread_Connect(void)
@@ -338,39 +1109,72 @@ void MainWindow::emulationThread_Connect(void)
             &MainWindow::on_Emulation_Finished);
     connect(this->emulationThread, &Thread::EmulationThread::on_Emulation_Started, this,
             &MainWindow::on_Emulation_Started);
+    connect(this->emulationThread, &Thread::EmulationThread::on_Emulation_PluginSwapped, this,
+            &MainWindow::on_Emulation_PluginSwapped);
+    connect(this->emulationThread, &Thread::EmulationThread::on_Emulation_StateSaved, this,
+            &MainWindow::on_Emulation_StateSaved);
+    connect(this->emulationThread, &Thread::EmulationThread::on_Emulation_StateLoaded, this,
+            &MainWindow::on_Emulation_StateLoaded);
 
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_Init, this, &MainWindow::on_VidExt_Init,
-            Qt::BlockingQueuedConnection);
+            Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetupOGL, this, &MainWindow::on_VidExt_SetupOGL,
-            Qt::BlockingQueuedConnection);
+            Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetMode, this, &MainWindow::on_VidExt_SetMode,
-            Qt::BlockingQueuedConnection);
+            Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetModeWithRate, this,
-            &MainWindow::on_VidExt_SetModeWithRate, Qt::BlockingQueuedConnection);
+            &MainWindow::on_VidExt_SetModeWithRate, Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_ResizeWindow, this,
-            &MainWindow::on_VidExt_ResizeWindow, Qt::BlockingQueuedConnection);
+            &MainWindow::on_VidExt_ResizeWindow, Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetCaption, this,
-            &MainWindow::on_VidExt_SetCaption, Qt::BlockingQueuedConnection);
+            &MainWindow::on_VidExt_SetCaption, Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_ToggleFS, this, &MainWindow::on_VidExt_ToggleFS,
-            Qt::BlockingQueuedConnection);
+            Qt::DirectConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_Quit, this, &MainWindow::on_VidExt_Quit,
-            Qt::BlockingQueuedConnection);
+            Qt::DirectConnection);
+
+    // after our own connections, so on_Emulation_Finished
+    // has cleaned up before a queued launch starts
+    this->emulationLifecycle->SetThread(this->emulationThread);
+
+    connect(this->emulationLifecycle, &EmulationLifecycle::on_Lifecycle_StateChanged, this,
+            &MainWindow::on_Lifecycle_StateChanged);
+    connect(this->emulationLifecycle, &EmulationLifecycle::on_Lifecycle_Launch, this,
+            &MainWindow::on_Lifecycle_Launch);
+    connect(this->emulationLifecycle, &EmulationLifecycle::on_Lifecycle_Timeout, this,
+            &MainWindow::on_Lifecycle_Timeout);
 }
 
 void MainWindow::emulationThread_Launch(QString file)
+{
+    // anything still running is stopped first,
+    // on_Lifecycle_Launch is called once it has
+    this->emulationLifecycle->Launch(file);
+}
+
+void MainWindow::on_Lifecycle_Launch(QString file)
 {
     g_MupenApi.Config.Save();
 
-    if (this->emulationThread->isRunning())
-    {
-        this->on_Action_File_EndEmulation();
+    this->ui_AllowManualResizing = g_Settings.GetBoolValue(SettingsID::GUI_AllowManualResizing);
+    this->ui_NativeWindow = g_Settings.GetBoolValue(SettingsID::GUI_NativeRenderWindow);
+    this->ui_NativeFullscreen = g_Settings.GetBoolValue(SettingsID::GUI_NativeRenderFullscreen);
+    this->ui_SwapInterval = g_Settings.GetIntValue(SettingsID::GUI_SwapInterval);
 
-        while (this->emulationThread->isRunning())
-            QCoreApplication::processEvents();
-    }
+    if (this->ui_NativeWindow)
+        g_OGLWidget = this->ui_Widget_OpenGL_Native;
+    else
+        g_OGLWidget = this->ui_Widget_OpenGL;
 
-    this->ui_AllowManualResizing = g_Settings.GetBoolValue(SettingsID::GUI_AllowManualResizing);
-    this->ui_Widget_OpenGL->SetAllowResizing(this->ui_AllowManualResizing);
+    g_OGLWidget->SetAllowResizing(this->ui_AllowManualResizing);
+    // scaling on resize needs our own render target
+    bool scale = g_Settings.GetBoolValue(SettingsID::GUI_ScaleOnResize);
+    g_OGLWidget->SetOffscreen(scale || g_Settings.GetBoolValue(SettingsID::GUI_OffscreenRendering));
+    g_OGLWidget->SetScaleOnResize(scale, g_Settings.GetIntValue(SettingsID::GUI_ScaleFilter) == 1);
+
+    g_MupenApi.Core.SetRewind(g_Settings.GetBoolValue(SettingsID::GUI_RewindEnabled),
+                              g_Settings.GetIntValue(SettingsID::GUI_RewindInterval),
+                              g_Settings.GetIntValue(SettingsID::GUI_RewindBufferSize) * 1024LL * 1024LL);
 
     this->emulationThread->SetRomFile(file);
     this->emulationThread->start();
@@ -395,16 +1199,25 @@ void MainWindow::menuBar_Actions_Init(void)
     this->action_System_Pause = new QAction(this);
     this->action_System_GenerateBitmap = new QAction(this);
     this->action_System_LimitFPS = new QAction(this);
+    this->menu_System_Speed = new QMenu(this);
+    this->group_System_Speed = new QActionGroup(this);
+    this->action_System_IncreaseSpeed = new QAction(this);
+    this->action_System_DecreaseSpeed = new QAction(this);
     this->action_System_SwapDisk = new QAction(this);
     this->action_System_SaveState = new QAction(this);
     this->action_System_SaveAs = new QAction(this);
     this->action_System_LoadState = new QAction(this);
     this->action_System_Load = new QAction(this);
+    this->action_System_SaveStates = new QAction(this);
     this->menu_System_CurrentSaveState = new QMenu(this);
+    this->group_System_CurrentSaveState = new QActionGroup(this);
+    this->menu_System_SwapPlugin = new QMenu(this);
     this->action_System_Cheats = new QAction(this);
     this->action_System_GSButton = new QAction(this);
 
     this->action_Options_FullScreen = new QAction(this);
+    this->action_Options_FrameTimeGraph = new QAction(this);
+    this->action_Options_StatsOverlay = new QAction(this);
     this->action_Options_ConfigGfx = new QAction(this);
     this->action_Options_ConfigAudio = new QAction(this);
     this->action_Options_ConfigRsp = new QAction(this);
@@ -461,7 +1274,20 @@ void MainWindow::menuBar_Actions_Setup(bool inEmulation, bool isPaused)
     this->action_System_LimitFPS->setText("Limit FPS");
     this->action_System_LimitFPS->setShortcut(QKeySequence(keyBinding));
     this->action_System_LimitFPS->setCheckable(true);
-    this->action_System_LimitFPS->setChecked(true);
+    this->action_System_LimitFPS->setChecked(this->ui_Speed != 0);
+    this->menu_System_Speed->setTitle("Speed");
+    keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_IncreaseSpeed);
+    this->action_System_IncreaseSpeed->setText("Increase Speed");
+    this->action_System_IncreaseSpeed->setShortcut(QKeySequence(keyBinding));
+    keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_DecreaseSpeed);
+    this->action_System_DecreaseSpeed->setText("Decrease Speed");
+    this->action_System_DecreaseSpeed->setShortcut(QKeySequence(keyBinding));
+    // fast-forward is held rather than triggered,
+    // so it's handled by the key events instead of an action
+    keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_FastForward);
+    this->ui_Speed_FastForwardKey = QKeySequence(keyBinding)[0] & ~Qt::KeyboardModifierMask;
+    keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_Rewind);
+    this->ui_Rewind_Key = QKeySequence(keyBinding)[0] & ~Qt::KeyboardModifierMask;
     keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_SwapDisk);
     this->action_System_SwapDisk->setText("Swap Disk");
     this->action_System_SwapDisk->setShortcut(QKeySequence(keyBinding));
@@ -478,7 +1304,9 @@ void MainWindow::menuBar_Actions_Setup(bool inEmulation, bool isPaused)
     keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_Load);
     this->action_System_Load->setText("Load...");
     this->action_System_Load->setShortcut(QKeySequence(keyBinding));
+    this->action_System_SaveStates->setText("Save States...");
     this->menu_System_CurrentSaveState->setTitle("Current Save State");
+    this->menu_System_SwapPlugin->setTitle("Swap Plugin");
     keyBinding = g_Settings.GetStringValue(SettingsID::KeyBinding_Cheats);
     this->action_System_Cheats->setText("Cheats...");
     this->action_System_Cheats->setShortcut(QKeySequence(keyBinding));
@@ -490,6 +1318,12 @@ void MainWindow::menuBar_Actions_Setup(bool inEmulation, bool isPaused)
     this->action_Options_FullScreen->setText("Full Screen");
     this->action_Options_FullScreen->setEnabled(inEmulation);
     this->action_Options_FullScreen->setShortcut(QKeySequence(keyBinding));
+    this->action_Options_FrameTimeGraph->setText("Show Frame Time Graph");
+    this->action_Options_FrameTimeGraph->setCheckable(true);
+    this->action_Options_FrameTimeGraph->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_ShowFrameTimeGraph));
+    this->action_Options_StatsOverlay->setText("Show Performance Overlay");
+    this->action_Options_StatsOverlay->setCheckable(true);
+    this->action_Options_StatsOverlay->setChecked(g_Settings.GetBoolValue(SettingsID::GUI_ShowStatsOverlay));
     this->action_Options_ConfigGfx->setText("Configure Graphics Plugin...");
     this->action_Options_ConfigGfx->setEnabled(g_MupenApi.Core.HasPluginConfig(M64P::Wrapper::PluginType::Gfx));
     this->action_Options_ConfigAudio->setText("Configure Audio Plugin...");
@@ -522,14 +1356,24 @@ void MainWindow::menuBar_Actions_Connect(void)
     connect(this->action_System_GenerateBitmap, &QAction::triggered, this,
             &MainWindow::on_Action_System_GenerateBitmap);
     connect(this->action_System_LimitFPS, &QAction::triggered, this, &MainWindow::on_Action_System_LimitFPS);
+    connect(this->action_System_IncreaseSpeed, &QAction::triggered, this,
+            &MainWindow::on_Action_System_IncreaseSpeed);
+    connect(this->action_System_DecreaseSpeed, &QAction::triggered, this,
+            &MainWindow::on_Action_System_DecreaseSpeed);
     connect(this->action_System_SwapDisk, &QAction::triggered, this, &MainWindow::on_Action_System_SwapDisk);
     connect(this->action_System_SaveState, &QAction::triggered, this, &MainWindow::on_Action_System_SaveState);
     connect(this->action_System_SaveAs, &QAction::triggered, this, &MainWindow::on_Action_System_SaveAs);
     connect(this->action_System_LoadState, &QAction::triggered, this, &MainWindow::on_Action_System_LoadState);
     connect(this->action_System_Load, &QAction::triggered, this, &MainWindow::on_Action_System_Load);
+    connect(this->action_System_SaveStates, &QAction::triggered, this, &MainWindow::on_Action_System_SaveStates);
     connect(this->action_System_Cheats, &QAction::triggered, this, &MainWindow::on_Action_System_Cheats);
     connect(this->action_System_GSButton, &QAction::triggered, this, &MainWindow::on_Action_System_GSButton);
 
+    connect(this->action_Options_FullScreen, &QAction::triggered, this, &MainWindow::on_Action_Options_FullScreen);
+    connect(this->action_Options_FrameTimeGraph, &QAction::triggered, this,
+            &MainWindow::on_Action_Options_FrameTimeGraph);
+    connect(this->action_Options_StatsOverlay, &QAction::triggered, this,
+            &MainWindow::on_Action_Options_StatsOverlay);
     connect(this->action_Options_ConfigGfx, &QAction::triggered, this, &MainWindow::on_Action_Options_ConfigGfx);
     connect(this->action_Options_ConfigAudio, &QAction::triggered, this, &MainWindow::on_Action_Options_ConfigAudio);
     connect(this->action_Options_ConfigRsp, &QAction::triggered, this, &MainWindow::on_Action_Options_ConfigRsp);
@@ -550,6 +1394,24 @@ void MainWindow::on_EventFilter_KeyPressed(QKeyEvent *event)
         return;
     }
 
+    if (this->ui_Speed_FastForwardKey != 0 && event->key() == this->ui_Speed_FastForwardKey)
+    {
+        if (!event->isAutoRepeat() && !this->ui_Speed_FastForward)
+        {
+            this->ui_Speed_FastForward = true;
+            this->ui_Speed_Apply();
+            this->statusBar()->showMessage("Fast-Forward: " + this->ui_Speed_Text(APP_FASTFORWARD_SPEED));
+        }
+        return;
+    }
+
+    if (this->ui_Rewind_Key != 0 && event->key() == this->ui_Rewind_Key)
+    {
+        if (!event->isAutoRepeat())
+            this->ui_Rewind_Set(true);
+        return;
+    }
+
     int key = Utilities::QtKeyToSdl2Key(event->key());
     int mod = Utilities::QtModKeyToSdl2ModKey(event->modifiers());
 
@@ -564,37 +1426,47 @@ void MainWindow::on_EventFilter_KeyReleased(QKeyEvent *event)
         return;
     }
 
+    if (this->ui_Speed_FastForwardKey != 0 && event->key() == this->ui_Speed_FastForwardKey)
+    {
+        if (!event->isAutoRepeat() && this->ui_Speed_FastForward)
+        {
+            this->ui_Speed_FastForward = false;
+            this->ui_Speed_Apply();
+            this->statusBar()->showMessage("Speed: " + this->ui_Speed_Text(this->ui_Speed), 3000);
+        }
+        return;
+    }
+
+    if (this->ui_Rewind_Key != 0 && event->key() == this->ui_Rewind_Key)
+    {
+        if (!event->isAutoRepeat())
+            this->ui_Rewind_Set(false);
+        return;
+    }
+
     int key = Utilities::QtKeyToSdl2Key(event->key());
     int mod = Utilities::QtModKeyToSdl2ModKey(event->modifiers());
 
     g_MupenApi.Core.SetKeyUp(key, mod);
 }
 
-/* TODO for some day
-void MainWindow::on_EventFilter_FocusIn(QFocusEvent *event)
+void MainWindow::on_EventFilter_WindowChanged(void)
 {
-    std::cout << "MainWindow::on_EventFilter_FocusIn" << std::endl;
-    if (g_Settings.GetBoolValue(SettingsID::GUI_ResumeEmulationOnFocus))
-    {
-        if (g_MupenApi.Core.isEmulationPaused())
-            this->on_Action_System_Pause();
-    }
-
-    QMainWindow::focusInEvent(event);
+    this->ui_Idle_Update();
 }
 
-void MainWindow::on_EventFilter_FocusOut(QFocusEvent *event)
+void MainWindow::on_Application_StateChanged(Qt::ApplicationState state)
 {
-    std::cout << "MainWindow::on_EventFilter_FocusOut" << std::endl;
-    if (g_Settings.GetBoolValue(SettingsID::GUI_PauseEmulationOnFocusLoss))
+    // nothing tells us about memory pressure on the desktop,
+    // being sent to the background is the closest we get
+    if ((state == Qt::ApplicationHidden || state == Qt::ApplicationSuspended) &&
+        !this->emulationThread->isRunning())
     {
-        if (g_MupenApi.Core.IsEmulationRunning())
-            this->on_Action_System_Pause();
+        g_MupenApi.Core.TrimPlugins();
     }
 
-    QMainWindow::focusOutEvent(event);
+    this->ui_Idle_Update();
 }
-*/
 
 void MainWindow::on_Action_File_OpenRom(void)
 {
@@ -629,15 +1501,7 @@ void MainWindow::on_Action_File_OpenCombo(void)
 
 void MainWindow::on_Action_File_EndEmulation(void)
 {
-    if (g_MupenApi.Core.isEmulationPaused())
-    {
-        this->on_Action_System_Pause();
-    }
-
-    if (!g_MupenApi.Core.StopEmulation())
-    {
-        this->ui_MessageBox("Error", "Api::Core::StopEmulation Failed!", g_MupenApi.Core.GetLastError());
-    }
+    this->emulationLifecycle->Stop();
 }
 
 void MainWindow::on_Action_File_ChooseDirectory(void)
@@ -688,33 +1552,11 @@ void MainWindow::on_Action_System_HardReset(void)
 
 void MainWindow::on_Action_System_Pause(void)
 {
-    static bool paused = false;
-
-    bool ret;
-    QString error = "Api::Core::";
-
-    if (!paused)
-    {
-        ret = g_MupenApi.Core.PauseEmulation();
-        error += "PauseEmulation";
-    }
-    else
+    // the menu follows in on_Lifecycle_StateChanged
+    if (!this->emulationLifecycle->TogglePause())
     {
-        ret = g_MupenApi.Core.ResumeEmulation();
-        error += "ResumeEmulation";
+        this->ui_MessageBox("Error", "Api::Core::TogglePause Failed!", g_MupenApi.Core.GetLastError());
     }
-
-    error += " Failed!";
-
-    paused = !paused;
-
-    if (!ret)
-    {
-        this->ui_MessageBox("Error", error, g_MupenApi.Core.GetLastError());
-        return;
-    }
-
-    this->menuBar_Setup(true, paused);
 }
 
 void MainWindow::on_Action_System_GenerateBitmap(void)
@@ -725,24 +1567,19 @@ void MainWindow::on_Action_System_GenerateBitmap(void)
     }
 }
 
-#include <iostream>
 void MainWindow::on_Action_System_LimitFPS(void)
 {
-    bool enabled, ret;
-
-    enabled = this->action_System_LimitFPS->isChecked();
-
-    std::cout << "enabled: " << enabled << std::endl;
+    this->ui_Speed_Set(this->action_System_LimitFPS->isChecked() ? 100 : 0);
+}
 
-    if (enabled)
-        ret = g_MupenApi.Core.EnableSpeedLimiter();
-    else
-        ret = g_MupenApi.Core.DisableSpeedLimiter();
+void MainWindow::on_Action_System_IncreaseSpeed(void)
+{
+    this->ui_Speed_Step(1);
+}
 
-    if (!ret)
-    {
-        this->ui_MessageBox("Error", "aaaa Failed", g_MupenApi.Core.GetLastError());
-    }
+void MainWindow::on_Action_System_DecreaseSpeed(void)
+{
+    this->ui_Speed_Step(-1);
 }
 
 void MainWindow::on_Action_System_SwapDisk(void)
@@ -759,20 +1596,22 @@ void MainWindow::on_Action_System_SaveState(void)
 
 void MainWindow::on_Action_System_SaveAs(void)
 {
-    bool isPaused = g_MupenApi.Core.isEmulationPaused();
-
-    if (!isPaused)
-        this->on_Action_System_Pause();
+    // capture the state as it is now, the emulation
+    // keeps running while the dialog is open
+    if (!g_MupenApi.Core.CaptureState())
+    {
+        this->ui_MessageBox("Error", "Api::Core::CaptureState Failed", g_MupenApi.Core.GetLastError());
+        return;
+    }
 
     QString fileName = QFileDialog::getSaveFileName(this, tr("Save State"), "", tr("SaveState (*.dat);;All Files (*)"));
+    if (fileName.isEmpty())
+        return;
 
-    if (!g_MupenApi.Core.SaveStateAsFile(fileName))
+    if (!g_MupenApi.Core.SaveCapturedState(fileName))
     {
-        this->ui_MessageBox("Error", "Api::Core::SaveStateAsFile Failed", g_MupenApi.Core.GetLastError());
+        this->ui_MessageBox("Error", "Api::Core::SaveCapturedState Failed", g_MupenApi.Core.GetLastError());
     }
-
-    if (!isPaused)
-        this->on_Action_System_Pause();
 }
 
 void MainWindow::on_Action_System_LoadState(void)
@@ -793,7 +1632,25 @@ void MainWindow::on_Action_System_Load(void)
     QString fileName =
         QFileDialog::getOpenFileName(this, tr("Open Save State"), "", tr("SaveState (*.dat);;All Files (*)"));
 
-    if (!g_MupenApi.Core.LoadStateFromFile(fileName))
+    if (!fileName.isEmpty() && !g_MupenApi.Core.LoadStateFromFile(fileName))
+    {
+        this->ui_MessageBox("Error", "Api::Core::LoadStateFromFile Failed", g_MupenApi.Core.GetLastError());
+    }
+
+    if (!isPaused)
+        this->on_Action_System_Pause();
+}
+
+void MainWindow::on_Action_System_SaveStates(void)
+{
+    bool isPaused = g_MupenApi.Core.isEmulationPaused();
+
+    if (!isPaused)
+        this->on_Action_System_Pause();
+
+    Dialog::SaveStateDialog dialog(this);
+
+    if (dialog.exec() == QDialog::Accepted && !g_MupenApi.Core.LoadStateFromFile(dialog.GetSelectedFile()))
     {
         this->ui_MessageBox("Error", "Api::Core::LoadStateFromFile Failed", g_MupenApi.Core.GetLastError());
     }
@@ -822,8 +1679,51 @@ void MainWindow::on_Action_System_GSButton(void)
     }
 }
 
+void MainWindow::on_Action_System_SwapPlugin(Plugin_t plugin)
+{
+    this->statusBar()->showMessage("Swapping to " + plugin.Name + "...");
+
+    if (!g_MupenApi.Core.SwapPlugin(plugin))
+    {
+        this->statusBar()->clearMessage();
+        this->ui_MessageBox("Error", "Api::Core::SwapPlugin Failed", g_MupenApi.Core.GetLastError());
+    }
+}
+
 void MainWindow::on_Action_Options_FullScreen(void)
 {
+    this->ui_FullScreen_Setup(!this->ui_FullScreen);
+}
+
+void MainWindow::on_Action_Options_FrameTimeGraph(void)
+{
+    bool show = this->action_Options_FrameTimeGraph->isChecked();
+
+    g_Settings.SetValue(SettingsID::GUI_ShowFrameTimeGraph, show);
+
+    if (show && this->emulationThread->isRunning())
+        this->ui_FrameTimeGraph_Start();
+    else
+        this->ui_Widget_FrameTimeGraph->Stop();
+}
+
+void MainWindow::on_Action_Options_StatsOverlay(void)
+{
+    bool show = this->action_Options_StatsOverlay->isChecked();
+
+    g_Settings.SetValue(SettingsID::GUI_ShowStatsOverlay, show);
+
+    if (!this->emulationThread->isRunning())
+        return;
+
+    Widget::OGLTextOverlay *overlay = g_OGLWidget->GetTextOverlay();
+    if (show && !overlay->Init(MUPEN_DATA_DIR "/font.ttf", 16))
+    {
+        g_Logger.AddText(overlay->GetLastError());
+        return;
+    }
+
+    overlay->SetEnabled(show);
 }
 
 void MainWindow::on_Action_Options_ConfigGfx(void)
@@ -883,6 +1783,7 @@ void MainWindow::on_Action_Help_About(void)
 void MainWindow::on_Emulation_Started(void)
 {
     this->ui_InEmulation(true, false);
+    this->ui_Resume_Button->hide();
 }
 
 void MainWindow::on_Emulation_Finished(bool ret)
@@ -891,6 +1792,188 @@ void MainWindow::on_Emulation_Finished(bool ret)
         this->ui_MessageBox("Error", "EmulationThread::run Failed", this->emulationThread->GetLastError());
 
     this->ui_InEmulation(false, false);
+    this->ui_Widget_FrameTimeGraph->Stop();
+    this->ui_Stats_Stop();
+
+    // the key release won't arrive anymore,
+    // don't start the next game muted
+    if (this->ui_Speed_FastForward || this->ui_Rewind)
+    {
+        this->ui_Speed_FastForward = false;
+        this->ui_Rewind = false;
+        g_MupenApi.Core.SetRewindActive(false);
+        this->ui_Speed_Apply();
+    }
+
+    if (g_OGLWidget == this->ui_Widget_OpenGL_Native)
+        this->ui_Native_Hide();
+
+    // the next game starts out active
+    this->ui_Idle_Timer.stop();
+    this->ui_Idle_Set(false);
+
+    // a failed launch never got to load it
+    g_MupenApi.Core.SetResumeState(QString());
+    this->ui_Resume_Timer.invalidate();
+    this->ui_Resume_Setup();
+}
+
+void MainWindow::on_Emulation_PluginSwapped(bool success, int time)
+{
+    if (!success)
+    {
+        this->statusBar()->clearMessage();
+        this->ui_MessageBox("Error", "Plugin swap failed", g_MupenApi.Core.GetLastError());
+        return;
+    }
+
+    this->statusBar()->showMessage("Plugin swapped in " + QString::number(time) + "ms", 5000);
+
+    // keep System -> Swap Plugin up-to-date
+    this->menuBar_Setup(true, false);
+}
+
+void MainWindow::on_Emulation_StateSaved(bool success, QString file)
+{
+    if (!success)
+    {
+        this->ui_MessageBox("Error", "Saving state failed", file);
+        return;
+    }
+
+    this->statusBar()->showMessage("Saved state to " + QFileInfo(file).fileName(), 3000);
+
+    // keep System -> Current Save State up-to-date
+    this->menuBar_Setup(true, g_MupenApi.Core.isEmulationPaused());
+}
+
+void MainWindow::on_Emulation_StateLoaded(bool success)
+{
+    bool resumed = this->ui_Resume_Timer.isValid();
+    qint64 resumeTime = this->ui_Resume_Timer.elapsed();
+
+    this->ui_Resume_Timer.invalidate();
+
+    if (!success)
+    {
+        this->ui_MessageBox("Error", "Loading state failed", g_MupenApi.Core.GetLastError());
+        return;
+    }
+
+    if (!resumed)
+    {
+        this->statusBar()->showMessage("State loaded", 3000);
+        return;
+    }
+
+    QSettings suspendInfo(this->ui_Suspend_File() + ".ini", QSettings::IniFormat);
+    QString message;
+    Plugin_t plugin;
+
+    message = "Resumed in " + QString::number(resumeTime) + "ms (startup ";
+    message += QString::number(this->ui_Resume_StartupTime) + "ms, state ";
+    message += QString::number(resumeTime - this->ui_Resume_StartupTime) + "ms)";
+
+    // states don't hold plugin state, a different
+    // plugin usually copes but is worth knowing about
+    for (int i = 0; i < 4; i++)
+    {
+        if (g_MupenApi.Core.GetCurrentPlugin((PluginType)i, &plugin) &&
+            plugin.Name != suspendInfo.value("Plugins/" + QString::number(i)).toString())
+        {
+            message += ", plugins differ from the suspended session";
+            break;
+        }
+    }
+
+    g_Logger.AddText("MainWindow::on_Emulation_StateLoaded: " + message);
+    this->statusBar()->showMessage(message, 5000);
+
+    // resumed, the next exit suspends again
+    this->ui_Suspend_Clear();
+}
+
+void MainWindow::on_Lifecycle_StateChanged(EmulationState from, EmulationState to)
+{
+    if (to == EmulationState::Paused || (from == EmulationState::Paused && to == EmulationState::Running))
+        this->menuBar_Setup(true, to == EmulationState::Paused);
+
+    // our own resume clears the flag first, so this is the user
+    // resuming while idle, their next pause isn't ours to undo
+    if (from == EmulationState::Paused && to == EmulationState::Running)
+        this->ui_Idle_Paused = false;
+
+    // launched while minimized, or resumed by the user
+    if (to == EmulationState::Running)
+        this->ui_Idle_Update();
+
+    // closeEvent was waiting on this
+    if (to == EmulationState::Idle && this->ui_CloseRequested)
+    {
+        this->ui_CloseRequested = false;
+        this->ui_CloseSuspended = false;
+        this->close();
+    }
+}
+
+void MainWindow::on_Lifecycle_Timeout(EmulationState state)
+{
+    QString report;
+    QString text;
+
+    // a suspend that doesn't finish in time
+    // becomes a plain stop before anything else
+    if (state == EmulationState::Stopping && this->ui_CloseSuspended)
+    {
+        this->ui_Close_Escalate();
+        return;
+    }
+
+    report = this->ui_HangReport(state);
+
+    switch (state)
+    {
+    case EmulationState::Launching:
+        text = "Emulation didn't start in time, it's being stopped";
+        break;
+    case EmulationState::Running:
+        text = "Emulation stopped producing frames";
+        break;
+    default:
+        text = "Emulation didn't stop in time";
+        break;
+    }
+
+    g_Logger.AddText("MainWindow::on_Lifecycle_Timeout: " + text + "\n" + report);
+
+    QMessageBox msgBox;
+    msgBox.setWindowIcon(this->ui_Icon);
+    msgBox.setIcon(QMessageBox::Icon::Warning);
+    msgBox.setWindowTitle("Emulation Hang");
+    msgBox.setText(text);
+    msgBox.setInformativeText("A plugin might be hung, the details have been written to the log.");
+    msgBox.setDetailedText(report);
+    QPushButton *forceButton = msgBox.addButton("Force Quit", QMessageBox::DestructiveRole);
+    msgBox.addButton("Keep Waiting", QMessageBox::RejectRole);
+    msgBox.exec();
+
+    if (msgBox.clickedButton() == forceButton)
+        this->ui_ForceQuit();
+}
+
+void MainWindow::on_Plugins_Probed(void)
+{
+    EmulationState state = this->emulationLifecycle->GetState();
+
+    // Plugins::LoadSettings may
+    // have picked a fallback plugin
+    g_MupenApi.Config.Save();
+
+    // keep System -> Swap Plugin up-to-date
+    if (state == EmulationState::Idle)
+        this->menuBar_Setup(false, false);
+    else if (state == EmulationState::Running || state == EmulationState::Paused)
+        this->menuBar_Setup(true, state == EmulationState::Paused);
 }
 
 void MainWindow::on_RomBrowser_Selected(QString file)
@@ -900,35 +1983,81 @@ void MainWindow::on_RomBrowser_Selected(QString file)
 
 void MainWindow::on_VidExt_Init(void)
 {
+    if (this->ui_Resume_Timer.isValid())
+        this->ui_Resume_StartupTime = this->ui_Resume_Timer.elapsed();
+
     this->ui_InEmulation(true, false);
+
+    if (g_OGLWidget == this->ui_Widget_OpenGL_Native)
+        this->ui_Native_Show();
+
+    if (g_Settings.GetBoolValue(SettingsID::GUI_ShowFrameTimeGraph))
+        this->ui_FrameTimeGraph_Start();
+
+    this->ui_Stats_Start();
 }
 
 void MainWindow::on_VidExt_SetupOGL(QSurfaceFormat format, QThread *thread)
 {
-    this->ui_Widget_OpenGL->SetThread(thread);
+    bool native = g_OGLWidget == this->ui_Widget_OpenGL_Native;
 
-    g_OGLWidget = this->ui_Widget_OpenGL;
+    // the native window has its own swap interval control
+    if (native && this->ui_SwapInterval >= 0)
+        format.setSwapInterval(this->ui_SwapInterval);
 
-    // this->ui_Widget_OpenGL->setCursor(Qt::BlankCursor);
-    this->ui_Widget_OpenGL->setFormat(format);
+    // offscreen rendering keeps our context on the GUI thread
+    if (g_OGLWidget->IsOffscreen())
+    {
+        if (!g_OGLWidget->GetFrameQueue()->CreateSurface(format))
+            g_Logger.AddText(g_OGLWidget->GetFrameQueue()->GetLastError());
+        g_OGLWidget->update();
+        return;
+    }
+
+    Plugin_t gfxPlugin;
+    g_MupenApi.Core.GetCurrentPlugin(PluginType::Gfx, &gfxPlugin);
+
+    // g_OGLWidget->setCursor(Qt::BlankCursor);
+    g_OGLWidget->setFormat(format);
+    g_OGLWidget->PrepareContext(format, gfxPlugin.FileName);
+    g_OGLWidget->SetThread(thread);
 }
 
 void MainWindow::on_VidExt_SetMode(int width, int height, int bps, int mode, int flags)
 {
     std::cout << "on_VidExt_SetMode" << std::endl;
     this->on_VidExt_ResizeWindow(width, height);
+
+    if (mode == M64VIDEO_FULLSCREEN && !this->ui_FullScreen)
+        this->ui_FullScreen_Setup(true);
 }
 
 void MainWindow::on_VidExt_SetModeWithRate(int width, int height, int refresh, int bps, int mode, int flags)
 {
     std::cout << "on_VidExt_SetModeWithRate" << std::endl;
     this->on_VidExt_ResizeWindow(width, height);
+
+    if (mode == M64VIDEO_FULLSCREEN && !this->ui_FullScreen)
+        this->ui_FullScreen_Setup(true);
 }
 
 void MainWindow::on_VidExt_ResizeWindow(int width, int height)
 {
     std::cout << "on_VidExt_ResizeWindow(" << width << "," << height << ");" << std::endl;
 
+    this->ui_VideoSize = QSize(width, height);
+
+    // fullscreen scales, the size gets applied when leaving it
+    if (this->ui_FullScreen)
+        return;
+
+    if (g_OGLWidget == this->ui_Widget_OpenGL_Native)
+    {
+        if (!this->ui_NativeFullscreen)
+            g_OGLWidget->resize(width, height);
+        return;
+    }
+
     if (!this->menuBar->isHidden())
         height += this->menuBar->height();
 
@@ -955,11 +2084,17 @@ void MainWindow::on_VidExt_SetCaption(QString title)
 void MainWindow::on_VidExt_ToggleFS(void)
 {
     std::cout << "on_VidExt_ToggleFS" << std::endl;
+    this->ui_FullScreen_Setup(!this->ui_FullScreen);
 }
 
 void MainWindow::on_VidExt_Quit(void)
 {
     std::cout << "on_VidExt_Quit" << std::endl;
+
+    if (this->ui_FullScreen && g_OGLWidget != this->ui_Widget_OpenGL_Native)
+        this->ui_FullScreen_Setup(false);
+
+    this->ui_VideoSize = QSize();
     this->ui_InEmulation(false, false);
     this->ui_LoadGeometry();
 }
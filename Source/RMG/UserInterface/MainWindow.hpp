@@ -12,20 +12,44 @@
 
 #include "../Globals.hpp"
 #include "../Thread/EmulationThread.hpp"
+#include "Dialog/SaveStateDialog.hpp"
 #include "Dialog/SettingsDialog.hpp"
+#include "EmulationLifecycle.hpp"
 #include "EventFilter.hpp"
+#include "Widget/FrameTimeGraphWidget.hpp"
 #include "Widget/OGLWidget.hpp"
 #include "Widget/RomBrowserWidget.hpp"
+#include "../Utilities/EmulationStats.hpp"
+#include "../Utilities/Profiler.hpp"
+#include "../Utilities/ThreadDump.hpp"
 
 #include <QAction>
+#include <QActionGroup>
 #include <QCloseEvent>
+#include <QElapsedTimer>
+#include <QLabel>
 #include <QMainWindow>
 #include <QOpenGLWidget>
+#include <QPushButton>
+#include <QScreen>
 #include <QSettings>
 #include <QStackedWidget>
+#include <QTimer>
+#include <QTimerEvent>
+
+#include <future>
 
 namespace UserInterface
 {
+// GUI_IdlePolicy, in the order of the settings dialog
+enum class IdlePolicy
+{
+    None = 0,
+    Pause,
+    SkipPresent,
+    ReduceSpeed
+};
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -40,9 +64,12 @@ class MainWindow : public QMainWindow
     QIcon ui_Icon;
 
     Thread::EmulationThread *emulationThread;
+    EmulationLifecycle *emulationLifecycle;
 
     QStackedWidget *ui_Widgets;
     Widget::OGLWidget *ui_Widget_OpenGL;
+    Widget::OGLWidget *ui_Widget_OpenGL_Native;
+    Widget::FrameTimeGraphWidget *ui_Widget_FrameTimeGraph;
     Widget::RomBrowserWidget *ui_Widget_RomBrowser;
     EventFilter *ui_EventFilter;
 
@@ -64,15 +91,24 @@ class MainWindow : public QMainWindow
     QAction *action_System_Pause;
     QAction *action_System_GenerateBitmap;
     QAction *action_System_LimitFPS;
+    QMenu *menu_System_Speed;
+    QActionGroup *group_System_Speed;
+    QAction *action_System_IncreaseSpeed;
+    QAction *action_System_DecreaseSpeed;
     QAction *action_System_SwapDisk;
     QAction *action_System_SaveState;
     QAction *action_System_SaveAs;
     QAction *action_System_LoadState;
     QAction *action_System_Load;
+    QAction *action_System_SaveStates;
     QMenu *menu_System_CurrentSaveState;
+    QActionGroup *group_System_CurrentSaveState;
+    QMenu *menu_System_SwapPlugin;
     QAction *action_System_Cheats;
     QAction *action_System_GSButton;
     QAction *action_Options_FullScreen;
+    QAction *action_Options_FrameTimeGraph;
+    QAction *action_Options_StatsOverlay;
     QAction *action_Options_ConfigGfx;
     QAction *action_Options_ConfigAudio;
     QAction *action_Options_ConfigRsp;
@@ -89,7 +125,46 @@ class MainWindow : public QMainWindow
 
     bool ui_AllowManualResizing;
 
+    bool ui_NativeWindow = false;
+    bool ui_NativeFullscreen = false;
+    bool ui_NativeClosing = false;
+    bool ui_CloseRequested = false;
+    bool ui_CloseSuspended = false;
+
+    Utilities::ThreadDump ui_ThreadDump;
+
+    bool ui_Idle = false;
+    bool ui_Idle_Paused = false;
+    IdlePolicy ui_Idle_Policy = IdlePolicy::None;
+    QTimer ui_Idle_Timer;
+
+    int ui_SwapInterval = -1;
+
+    bool ui_FullScreen = false;
+    QSize ui_VideoSize;
+
+    QLabel *ui_Label_Stats;
+    Utilities::EmulationStats ui_Stats;
+    int ui_Stats_TimerId = 0;
+
+    int ui_Speed = 100;
+    int ui_Speed_FastForwardKey = 0;
+    bool ui_Speed_FastForward = false;
+
+    int ui_Rewind_Key = 0;
+    bool ui_Rewind = false;
+
+    QPushButton *ui_Resume_Button;
+    QElapsedTimer ui_Resume_Timer;
+    qint64 ui_Resume_StartupTime = 0;
+
+    std::future<QByteArray> ui_Stylesheet;
+
+    Utilities::Profiler startup_Profiler;
+    void startup_Finish(void);
+
     void closeEvent(QCloseEvent *);
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE;
 
     void ui_Init();
     void ui_Setup();
@@ -98,6 +173,30 @@ class MainWindow : public QMainWindow
     void ui_InEmulation(bool, bool);
     void ui_SaveGeometry(void);
     void ui_LoadGeometry(void);
+    void ui_FrameTimeGraph_Start(void);
+    void ui_Stats_Start(void);
+    void ui_Stats_Stop(void);
+    void ui_Stats_Update(void);
+    void ui_Speed_Set(int);
+    void ui_Speed_Step(int);
+    void ui_Speed_Apply(void);
+    QString ui_Speed_Text(int);
+    void ui_Rewind_Set(bool);
+    QString ui_Suspend_File(void);
+    bool ui_Suspend(void);
+    void ui_Suspend_Clear(void);
+    void ui_Resume_Setup(void);
+    void ui_Resume(void);
+    QString ui_HangReport(EmulationState);
+    bool ui_Idle_Check(void);
+    void ui_Idle_Update(void);
+    void ui_Idle_Set(bool);
+    void ui_ForceQuit(void);
+    void ui_Close_Escalate(void);
+    void ui_Native_Show(void);
+    void ui_Native_Hide(void);
+    void ui_FullScreen_Setup(bool);
+    QScreen *ui_FullScreen_FindScreen(void);
 
     void menuBar_Init(void);
     void menuBar_Setup(bool, bool);
@@ -113,6 +212,8 @@ class MainWindow : public QMainWindow
   public slots:
     void on_EventFilter_KeyPressed(QKeyEvent *);
     void on_EventFilter_KeyReleased(QKeyEvent *);
+    void on_EventFilter_WindowChanged(void);
+    void on_Application_StateChanged(Qt::ApplicationState);
 
     void on_Action_File_OpenRom(void);
     void on_Action_File_OpenCombo(void);
@@ -125,15 +226,21 @@ class MainWindow : public QMainWindow
     void on_Action_System_Pause(void);
     void on_Action_System_GenerateBitmap(void);
     void on_Action_System_LimitFPS(void);
+    void on_Action_System_IncreaseSpeed(void);
+    void on_Action_System_DecreaseSpeed(void);
     void on_Action_System_SwapDisk(void);
     void on_Action_System_SaveState(void);
     void on_Action_System_SaveAs(void);
     void on_Action_System_LoadState(void);
     void on_Action_System_Load(void);
+    void on_Action_System_SaveStates(void);
     void on_Action_System_CurrentSaveState(int);
     void on_Action_System_Cheats(void);
     void on_Action_System_GSButton(void);
+    void on_Action_System_SwapPlugin(Plugin_t);
     void on_Action_Options_FullScreen(void);
+    void on_Action_Options_FrameTimeGraph(void);
+    void on_Action_Options_StatsOverlay(void);
     void on_Action_Options_ConfigGfx(void);
     void on_Action_Options_ConfigAudio(void);
     void on_Action_Options_ConfigRsp(void);
@@ -145,6 +252,15 @@ class MainWindow : public QMainWindow
 
     void on_Emulation_Started(void);
     void on_Emulation_Finished(bool);
+    void on_Emulation_PluginSwapped(bool, int);
+    void on_Emulation_StateSaved(bool, QString);
+    void on_Emulation_StateLoaded(bool);
+
+    void on_Lifecycle_StateChanged(UserInterface::EmulationState, UserInterface::EmulationState);
+    void on_Lifecycle_Launch(QString);
+    void on_Lifecycle_Timeout(UserInterface::EmulationState);
+
+    void on_Plugins_Probed(void);
 
     void on_RomBrowser_Selected(QString);
 
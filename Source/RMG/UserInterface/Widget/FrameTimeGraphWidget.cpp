@@ -0,0 +1,113 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FrameTimeGraphWidget.hpp"
+
+#include <QPainter>
+
+using namespace UserInterface::Widget;
+
+#define GRAPH_FRAMES 240
+#define GRAPH_MAX_MS 50.0
+
+FrameTimeGraphWidget::FrameTimeGraphWidget(QWidget *parent)
+    : QWidget(parent, Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus)
+{
+    this->setAttribute(Qt::WA_ShowWithoutActivating);
+    this->setAttribute(Qt::WA_TransparentForMouseEvents);
+    this->setFixedSize(GRAPH_FRAMES, 80);
+}
+
+FrameTimeGraphWidget::~FrameTimeGraphWidget(void)
+{
+}
+
+void FrameTimeGraphWidget::SetStats(Utilities::FrameStats *stats)
+{
+    this->stats = stats;
+}
+
+void FrameTimeGraphWidget::SetWindow(QWindow *window)
+{
+    this->window = window;
+}
+
+void FrameTimeGraphWidget::Start(void)
+{
+    if (this->timerId == 0)
+        this->timerId = this->startTimer(100);
+
+    this->show();
+}
+
+void FrameTimeGraphWidget::Stop(void)
+{
+    if (this->timerId != 0)
+    {
+        this->killTimer(this->timerId);
+        this->timerId = 0;
+    }
+
+    this->hide();
+}
+
+void FrameTimeGraphWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    qint64 frames[GRAPH_FRAMES];
+    int count = 0;
+
+    painter.fillRect(this->rect(), QColor(0, 0, 0, 160));
+
+    if (this->stats == nullptr)
+        return;
+
+    count = this->stats->GetRecentFrames(frames, GRAPH_FRAMES);
+
+    double scale = this->height() / GRAPH_MAX_MS;
+    double period = this->stats->GetRefreshPeriod();
+
+    // one and two refresh periods
+    if (period > 0)
+    {
+        painter.setPen(QColor(255, 255, 255, 80));
+        for (int i = 1; i <= 2; i++)
+        {
+            int y = this->height() - (int)(period * i * scale);
+            painter.drawLine(0, y, this->width(), y);
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        double ms = frames[i] / 1000000.0;
+        int x = this->width() - count + i;
+        int barHeight = qMin(this->height(), (int)(ms * scale));
+
+        if (period > 0 && ms > (period * 1.5))
+            painter.setPen(QColor(255, 80, 80));
+        else
+            painter.setPen(QColor(80, 255, 80));
+
+        painter.drawLine(x, this->height(), x, this->height() - barHeight);
+    }
+
+    painter.setPen(Qt::white);
+    painter.drawText(4, 14,
+                     "p50 " + QString::number(this->stats->GetPercentile(0.50), 'f', 1) + "ms  p99 " +
+                         QString::number(this->stats->GetPercentile(0.99), 'f', 1) + "ms");
+}
+
+void FrameTimeGraphWidget::timerEvent(QTimerEvent *event)
+{
+    if (this->window != nullptr && this->window->isVisible())
+        this->move(this->window->mapToGlobal(QPoint(8, 8)));
+
+    this->update();
+}
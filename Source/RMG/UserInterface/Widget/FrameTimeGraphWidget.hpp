@@ -0,0 +1,50 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FRAMETIMEGRAPHWIDGET_HPP
+#define FRAMETIMEGRAPHWIDGET_HPP
+
+#include "../../Utilities/FrameStats.hpp"
+
+#include <QPaintEvent>
+#include <QTimerEvent>
+#include <QWidget>
+#include <QWindow>
+
+namespace UserInterface
+{
+namespace Widget
+{
+// Frameless always-on-top window, a normal child widget
+// can't be drawn on top of the native OpenGL window
+class FrameTimeGraphWidget : public QWidget
+{
+  public:
+    FrameTimeGraphWidget(QWidget *);
+    ~FrameTimeGraphWidget(void);
+
+    void SetStats(Utilities::FrameStats *);
+    void SetWindow(QWindow *);
+
+    void Start(void);
+    void Stop(void);
+
+  protected:
+    void paintEvent(QPaintEvent *) Q_DECL_OVERRIDE;
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE;
+
+  private:
+    Utilities::FrameStats *stats = nullptr;
+    QWindow *window = nullptr;
+    int timerId = 0;
+};
+} // namespace Widget
+} // namespace UserInterface
+
+#endif // FRAMETIMEGRAPHWIDGET_HPP
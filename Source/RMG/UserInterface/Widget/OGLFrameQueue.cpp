@@ -0,0 +1,347 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "OGLFrameQueue.hpp"
+#include "../../Utilities/OpenGLContext.hpp"
+
+#include <QMutexLocker>
+#include <QRect>
+#include <utility>
+
+using namespace UserInterface::Widget;
+
+OGLFrameQueue::OGLFrameQueue(void)
+{
+}
+
+OGLFrameQueue::~OGLFrameQueue(void)
+{
+    if (this->render_Context != nullptr)
+        delete this->render_Context;
+}
+
+bool OGLFrameQueue::CreateSurface(QSurfaceFormat format)
+{
+    this->DestroySurface();
+
+    this->render_Surface = new QOffscreenSurface();
+    this->render_Surface->setFormat(format);
+    this->render_Surface->create();
+
+    if (!this->render_Surface->isValid())
+    {
+        this->error_Message = "OGLFrameQueue::CreateSurface: QOffscreenSurface::create Failed!";
+        this->DestroySurface();
+        return false;
+    }
+
+    return true;
+}
+
+void OGLFrameQueue::DestroySurface(void)
+{
+    if (this->render_Surface == nullptr)
+        return;
+
+    this->render_Surface->destroy();
+    delete this->render_Surface;
+    this->render_Surface = nullptr;
+}
+
+bool OGLFrameQueue::Present(QOpenGLContext *context, GLuint target, QSize size, bool integer)
+{
+    QOpenGLExtraFunctions *f = context->extraFunctions();
+    GLsync sync;
+    int index;
+
+    {
+        QMutexLocker locker(&this->frame_Mutex);
+
+        if (!this->frame_Valid)
+            return false;
+
+        if (this->frame_Fresh)
+        {
+            std::swap(this->frame_Ready, this->frame_Present);
+            this->frame_Fresh = false;
+        }
+
+        index = this->frame_Present;
+        sync = this->frame_Sync[index];
+        this->frame_Sync[index] = nullptr;
+
+        if (this->frame_Size[index].isEmpty())
+            return false;
+    }
+
+    // wait on the GPU, not on the CPU
+    if (sync != nullptr)
+    {
+        f->glWaitSync(sync, 0, GL_TIMEOUT_IGNORED);
+        f->glDeleteSync(sync);
+    }
+
+    // framebuffer objects aren't shared between contexts,
+    // so we need our own one to read from the shared texture
+    if (this->present_Framebuffer == 0)
+        f->glGenFramebuffers(1, &this->present_Framebuffer);
+
+    QSize frameSize = this->frame_Size[index];
+    QRect targetRect(QPoint(0, 0), size);
+    GLenum filter = GL_LINEAR;
+
+    // integer scaling keeps pixels sharp, centered in the window,
+    // it falls back to linear when the window is smaller than the frame
+    if (integer)
+    {
+        int scale = qMin(size.width() / frameSize.width(), size.height() / frameSize.height());
+        if (scale >= 1)
+        {
+            QSize scaledSize = frameSize * scale;
+            targetRect = QRect(QPoint((size.width() - scaledSize.width()) / 2,
+                                      (size.height() - scaledSize.height()) / 2),
+                               scaledSize);
+            filter = GL_NEAREST;
+        }
+    }
+
+    f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    if (targetRect.size() != size)
+    {
+        f->glClearColor(0, 0, 0, 1);
+        f->glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    f->glBindFramebuffer(GL_READ_FRAMEBUFFER, this->present_Framebuffer);
+    f->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->frame_Texture[index], 0);
+    f->glBlitFramebuffer(0, 0, frameSize.width(), frameSize.height(), targetRect.left(), targetRect.top(),
+                         targetRect.left() + targetRect.width(), targetRect.top() + targetRect.height(),
+                         GL_COLOR_BUFFER_BIT, filter);
+    f->glBindFramebuffer(GL_FRAMEBUFFER, target);
+    return true;
+}
+
+bool OGLFrameQueue::Init(QSurfaceFormat format)
+{
+    if (this->render_Surface == nullptr)
+    {
+        this->error_Message = "OGLFrameQueue::Init: no surface has been created!";
+        return false;
+    }
+
+    // the context is kept around between sessions,
+    // only create a new one when the format changed
+    this->render_Reused = this->render_Context != nullptr && this->render_Context->isValid() &&
+                          Utilities::OpenGLFormatMatches(this->render_Format, format);
+
+    if (!this->render_Reused)
+    {
+        if (this->render_Context != nullptr)
+            delete this->render_Context;
+
+        this->render_Context = new QOpenGLContext();
+        this->render_Context->setFormat(format);
+        this->render_Context->setShareContext(QOpenGLContext::globalShareContext());
+        this->render_Format = format;
+
+        if (!this->render_Context->create())
+        {
+            this->error_Message = "OGLFrameQueue::Init: QOpenGLContext::create Failed!";
+            delete this->render_Context;
+            this->render_Context = nullptr;
+            return false;
+        }
+    }
+
+    if (!this->render_Context->makeCurrent(this->render_Surface))
+    {
+        this->error_Message = "OGLFrameQueue::Init: QOpenGLContext::makeCurrent Failed!";
+        delete this->render_Context;
+        this->render_Context = nullptr;
+        return false;
+    }
+
+    if (this->render_Reused)
+        Utilities::OpenGLResetState(this->render_Context);
+
+    this->render_Functions = this->render_Context->extraFunctions();
+    this->render_UseSync = this->render_Context->format().majorVersion() >= 3 ||
+                           this->render_Context->hasExtension("GL_ARB_sync");
+
+    QOpenGLExtraFunctions *f = this->render_Functions;
+
+    f->glGenFramebuffers(1, &this->render_Framebuffer);
+    f->glGenRenderbuffers(1, &this->render_Color);
+    f->glGenRenderbuffers(1, &this->render_Depth);
+    f->glGenFramebuffers(OGLFRAMEQUEUE_SIZE, this->frame_Framebuffer);
+    f->glGenTextures(OGLFRAMEQUEUE_SIZE, this->frame_Texture);
+
+    QMutexLocker locker(&this->frame_Mutex);
+    for (int i = 0; i < OGLFRAMEQUEUE_SIZE; i++)
+    {
+        this->frame_Size[i] = QSize();
+        this->frame_Sync[i] = nullptr;
+    }
+    this->frame_Write = 0;
+    this->frame_Ready = 1;
+    this->frame_Present = 2;
+    this->frame_Fresh = false;
+    this->frame_Valid = true;
+    return true;
+}
+
+void OGLFrameQueue::Quit(void)
+{
+    {
+        QMutexLocker locker(&this->frame_Mutex);
+        this->frame_Valid = false;
+    }
+
+    if (this->render_Context == nullptr)
+        return;
+
+    if (this->render_Functions != nullptr)
+    {
+        QOpenGLExtraFunctions *f = this->render_Functions;
+
+        for (int i = 0; i < OGLFRAMEQUEUE_SIZE; i++)
+        {
+            if (this->frame_Sync[i] != nullptr)
+                f->glDeleteSync(this->frame_Sync[i]);
+            this->frame_Sync[i] = nullptr;
+        }
+
+        f->glDeleteTextures(OGLFRAMEQUEUE_SIZE, this->frame_Texture);
+        f->glDeleteFramebuffers(OGLFRAMEQUEUE_SIZE, this->frame_Framebuffer);
+        f->glDeleteRenderbuffers(1, &this->render_Depth);
+        f->glDeleteRenderbuffers(1, &this->render_Color);
+        f->glDeleteFramebuffers(1, &this->render_Framebuffer);
+    }
+
+    // keep the context for the next session
+    this->render_Context->doneCurrent();
+    this->render_Functions = nullptr;
+    this->render_Framebuffer = 0;
+    this->render_Size = QSize();
+}
+
+void OGLFrameQueue::SetSize(int width, int height)
+{
+    QOpenGLExtraFunctions *f = this->render_Functions;
+    QSize size(width, height);
+
+    if (f == nullptr || size.isEmpty() || size == this->render_Size)
+        return;
+
+    // the plugin may cache the framebuffer id,
+    // so keep it and only re-allocate the storage
+    f->glBindRenderbuffer(GL_RENDERBUFFER, this->render_Color);
+    f->glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    f->glBindRenderbuffer(GL_RENDERBUFFER, this->render_Depth);
+    f->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    f->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, this->render_Framebuffer);
+    f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->render_Color);
+    f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, this->render_Depth);
+    f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, this->render_Depth);
+
+    this->render_Size = size;
+}
+
+void OGLFrameQueue::Swap(void)
+{
+    QOpenGLExtraFunctions *f = this->render_Functions;
+    GLint readBinding, drawBinding;
+    GLsync oldSync = nullptr;
+    int index;
+
+    if (f == nullptr || this->render_Size.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&this->frame_Mutex);
+        index = this->frame_Write;
+        oldSync = this->frame_Sync[index];
+        this->frame_Sync[index] = nullptr;
+    }
+
+    if (oldSync != nullptr)
+        f->glDeleteSync(oldSync);
+
+    if (this->frame_Size[index] != this->render_Size)
+        this->frame_Resize(index, this->render_Size);
+
+    f->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readBinding);
+    f->glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawBinding);
+
+    f->glBindFramebuffer(GL_READ_FRAMEBUFFER, this->render_Framebuffer);
+    f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->frame_Framebuffer[index]);
+    f->glBlitFramebuffer(0, 0, this->render_Size.width(), this->render_Size.height(), 0, 0,
+                         this->render_Size.width(), this->render_Size.height(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    f->glBindFramebuffer(GL_READ_FRAMEBUFFER, readBinding);
+    f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawBinding);
+
+    GLsync sync = nullptr;
+    if (this->render_UseSync)
+    {
+        sync = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        f->glFlush();
+    }
+    else
+    {
+        f->glFinish();
+    }
+
+    QMutexLocker locker(&this->frame_Mutex);
+    this->frame_Sync[index] = sync;
+    std::swap(this->frame_Write, this->frame_Ready);
+    this->frame_Fresh = true;
+}
+
+bool OGLFrameQueue::IsReused(void)
+{
+    return this->render_Reused;
+}
+
+GLuint OGLFrameQueue::GetFramebuffer(void)
+{
+    return this->render_Framebuffer;
+}
+
+QOpenGLContext *OGLFrameQueue::GetContext(void)
+{
+    return this->render_Context;
+}
+
+QString OGLFrameQueue::GetLastError(void)
+{
+    return this->error_Message;
+}
+
+void OGLFrameQueue::frame_Resize(int index, QSize size)
+{
+    QOpenGLExtraFunctions *f = this->render_Functions;
+
+    f->glBindTexture(GL_TEXTURE_2D, this->frame_Texture[index]);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.width(), size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    f->glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint binding;
+    f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &binding);
+    f->glBindFramebuffer(GL_FRAMEBUFFER, this->frame_Framebuffer[index]);
+    f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->frame_Texture[index], 0);
+    f->glBindFramebuffer(GL_FRAMEBUFFER, binding);
+
+    QMutexLocker locker(&this->frame_Mutex);
+    this->frame_Size[index] = size;
+}
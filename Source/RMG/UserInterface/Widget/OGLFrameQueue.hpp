@@ -0,0 +1,86 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef OGLFRAMEQUEUE_HPP
+#define OGLFRAMEQUEUE_HPP
+
+#include <QMutex>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QSize>
+#include <QString>
+#include <QSurfaceFormat>
+
+#define OGLFRAMEQUEUE_SIZE 3
+
+namespace UserInterface
+{
+namespace Widget
+{
+// Offscreen render target for the video plugin,
+// the render thread draws into a framebuffer we own,
+// which gets copied into a triple buffered set on swap,
+// the GUI thread then presents the latest finished frame
+class OGLFrameQueue
+{
+  public:
+    OGLFrameQueue(void);
+    ~OGLFrameQueue(void);
+
+    // GUI thread
+    bool CreateSurface(QSurfaceFormat);
+    void DestroySurface(void);
+    bool Present(QOpenGLContext *, GLuint, QSize, bool);
+
+    // render thread
+    bool Init(QSurfaceFormat);
+    bool IsReused(void);
+    void Quit(void);
+    void SetSize(int, int);
+    void Swap(void);
+
+    GLuint GetFramebuffer(void);
+    QOpenGLContext *GetContext(void);
+
+    QString GetLastError(void);
+
+  private:
+    QString error_Message;
+
+    QOffscreenSurface *render_Surface = nullptr;
+    QOpenGLContext *render_Context = nullptr;
+    QSurfaceFormat render_Format;
+    bool render_Reused = false;
+    QOpenGLExtraFunctions *render_Functions = nullptr;
+    GLuint render_Framebuffer = 0;
+    GLuint render_Color = 0;
+    GLuint render_Depth = 0;
+    QSize render_Size;
+    bool render_UseSync = false;
+
+    GLuint present_Framebuffer = 0;
+
+    QMutex frame_Mutex;
+    GLuint frame_Framebuffer[OGLFRAMEQUEUE_SIZE] = {0};
+    GLuint frame_Texture[OGLFRAMEQUEUE_SIZE] = {0};
+    QSize frame_Size[OGLFRAMEQUEUE_SIZE];
+    GLsync frame_Sync[OGLFRAMEQUEUE_SIZE] = {nullptr};
+    int frame_Write = 0;
+    int frame_Ready = 1;
+    int frame_Present = 2;
+    bool frame_Fresh = false;
+    bool frame_Valid = false;
+
+    void frame_Resize(int, QSize);
+};
+} // namespace Widget
+} // namespace UserInterface
+
+#endif // OGLFRAMEQUEUE_HPP
@@ -0,0 +1,520 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "OGLTextOverlay.hpp"
+
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QMutexLocker>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFunctions>
+#include <QPainter>
+
+using namespace UserInterface::Widget;
+
+// position, texture coordinate, color
+#define OGLTEXTOVERLAY_VERTEX_SIZE 8
+
+static const char *vertexSource = "ATTRIBUTE vec2 a_Position;\n"
+                                  "ATTRIBUTE vec2 a_TexCoord;\n"
+                                  "ATTRIBUTE vec4 a_Color;\n"
+                                  "VARYING vec2 v_TexCoord;\n"
+                                  "VARYING vec4 v_Color;\n"
+                                  "void main()\n"
+                                  "{\n"
+                                  "    v_TexCoord = a_TexCoord;\n"
+                                  "    v_Color = a_Color;\n"
+                                  "    gl_Position = vec4(a_Position, 0.0, 1.0);\n"
+                                  "}\n";
+
+static const char *fragmentSource = "uniform sampler2D u_Texture;\n"
+                                    "VARYING vec2 v_TexCoord;\n"
+                                    "VARYING vec4 v_Color;\n"
+                                    "void main()\n"
+                                    "{\n"
+                                    "    FRAG_COLOR = vec4(v_Color.rgb, v_Color.a * TEXTURE(u_Texture, v_TexCoord).a);\n"
+                                    "}\n";
+
+OGLTextOverlay::OGLTextOverlay(void)
+{
+}
+
+OGLTextOverlay::~OGLTextOverlay(void)
+{
+}
+
+bool OGLTextOverlay::Init(QString file, int pixelSize)
+{
+    if (this->atlas_Valid)
+        return true;
+
+    int id = QFontDatabase::addApplicationFont(file);
+    QStringList families = QFontDatabase::applicationFontFamilies(id);
+    if (id == -1 || families.isEmpty())
+    {
+        this->error_Message = "OGLTextOverlay::Init: QFontDatabase::addApplicationFont(" + file + ") Failed";
+        return false;
+    }
+
+    QFont font(families.first());
+    font.setPixelSize(pixelSize);
+    QFontMetrics metrics(font);
+
+    // one pixel of padding so neighbours never bleed in
+    int width = metrics.maxWidth() + 2;
+    int height = metrics.height() + 2;
+    int rows = (OGLTEXTOVERLAY_GLYPHS + OGLTEXTOVERLAY_COLUMNS - 1) / OGLTEXTOVERLAY_COLUMNS;
+
+    QImage image(width * OGLTEXTOVERLAY_COLUMNS, height * rows, QImage::Format_RGBA8888);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+
+    for (int i = 0; i < OGLTEXTOVERLAY_GLYPHS; i++)
+    {
+        int x = (i % OGLTEXTOVERLAY_COLUMNS) * width;
+        int y = (i / OGLTEXTOVERLAY_COLUMNS) * height;
+
+        if (i == OGLTEXTOVERLAY_GLYPHS - 1)
+        {
+            painter.fillRect(x, y, width, height, Qt::white);
+            this->atlas_Advance[i] = width;
+            continue;
+        }
+
+        QChar glyph(32 + i);
+        painter.drawText(x + 1, y + 1 + metrics.ascent(), QString(glyph));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        this->atlas_Advance[i] = metrics.horizontalAdvance(glyph);
+#else
+        this->atlas_Advance[i] = metrics.width(glyph);
+#endif
+    }
+
+    painter.end();
+
+    this->atlas_Image = image;
+    this->atlas_Cell = QSize(width, height);
+    this->atlas_Valid = true;
+    return true;
+}
+
+void OGLTextOverlay::SetEnabled(bool enabled)
+{
+    this->overlay_Enabled = enabled;
+}
+
+bool OGLTextOverlay::IsEnabled(void)
+{
+    return this->overlay_Enabled;
+}
+
+void OGLTextOverlay::SetText(QString text)
+{
+    QMutexLocker locker(&this->text_Mutex);
+
+    if (this->text_String == text)
+        return;
+
+    this->text_String = text;
+    this->text_Changed = true;
+}
+
+void OGLTextOverlay::Render(QOpenGLContext *context, GLuint framebuffer, QSize size)
+{
+    if (!this->overlay_Enabled || !this->atlas_Valid || size.isEmpty())
+        return;
+
+    bool rebuild = false;
+
+    {
+        QMutexLocker locker(&this->text_Mutex);
+        if (this->text_Changed)
+        {
+            this->gl_Text = this->text_String;
+            this->text_Changed = false;
+            rebuild = true;
+        }
+    }
+
+    if (this->gl_Text.isEmpty())
+        return;
+
+    QOpenGLFunctions *f = context->functions();
+    QOpenGLExtraFunctions *ef = context->extraFunctions();
+    bool modern = context->isOpenGLES() ? context->format().majorVersion() >= 3
+                                        : context->format().profile() == QSurfaceFormat::CoreProfile;
+    bool samplers = modern && (context->isOpenGLES() || context->format().version() >= qMakePair(3, 3));
+
+    // save everything we're about to touch
+    GLint program, activeTexture, texture, arrayBuffer, viewport[4];
+    GLint drawFramebuffer, readFramebuffer = 0, vertexArray = 0, sampler = 0;
+    GLint blendSrcRgb, blendDstRgb, blendSrcAlpha, blendDstAlpha, blendEquationRgb, blendEquationAlpha;
+    GLboolean blend, depthTest, scissorTest, stencilTest, cullFace;
+    GLint attribEnabled[3], attribSize[3], attribType[3], attribNormalized[3], attribStride[3], attribBuffer[3];
+    void *attribPointer[3];
+
+    f->glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    f->glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    f->glActiveTexture(GL_TEXTURE0);
+    f->glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+    f->glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+    f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    f->glGetIntegerv(GL_VIEWPORT, viewport);
+    f->glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRgb);
+    f->glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRgb);
+    f->glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+    f->glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+    f->glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquationRgb);
+    f->glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquationAlpha);
+    blend = f->glIsEnabled(GL_BLEND);
+    depthTest = f->glIsEnabled(GL_DEPTH_TEST);
+    scissorTest = f->glIsEnabled(GL_SCISSOR_TEST);
+    stencilTest = f->glIsEnabled(GL_STENCIL_TEST);
+    cullFace = f->glIsEnabled(GL_CULL_FACE);
+
+    if (modern)
+    {
+        f->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+        f->glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+        if (samplers)
+            f->glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+    }
+    else
+    {
+        // without a vertex array object of our own
+        // the plugin's attribute setup would get lost
+        for (int i = 0; i < 3; i++)
+        {
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &attribEnabled[i]);
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_SIZE, &attribSize[i]);
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_TYPE, &attribType[i]);
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &attribNormalized[i]);
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &attribStride[i]);
+            f->glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &attribBuffer[i]);
+            f->glGetVertexAttribPointerv(i, GL_VERTEX_ATTRIB_ARRAY_POINTER, &attribPointer[i]);
+        }
+    }
+
+    // a new context means our objects are gone
+    if (context != this->gl_Context)
+    {
+        this->gl_Context = context;
+        this->gl_Modern = modern;
+        this->gl_Valid = this->gl_Init(context);
+        rebuild = true;
+    }
+
+    if (this->gl_Valid)
+    {
+        if (modern)
+        {
+            ef->glBindVertexArray(this->gl_VertexArray);
+            if (samplers)
+                ef->glBindSampler(0, 0);
+        }
+
+        f->glBindBuffer(GL_ARRAY_BUFFER, this->gl_Buffer);
+
+        if (rebuild || size != this->gl_Size)
+        {
+            this->gl_Size = size;
+            this->gl_Build(context);
+        }
+
+        if (!modern)
+        {
+            for (int i = 0; i < 3; i++)
+                f->glEnableVertexAttribArray(i);
+            f->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float), (void *)0);
+            f->glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float),
+                                     (void *)(2 * sizeof(float)));
+            f->glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float),
+                                     (void *)(4 * sizeof(float)));
+        }
+
+        f->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        f->glViewport(0, 0, size.width(), size.height());
+        f->glDisable(GL_DEPTH_TEST);
+        f->glDisable(GL_SCISSOR_TEST);
+        f->glDisable(GL_STENCIL_TEST);
+        f->glDisable(GL_CULL_FACE);
+        f->glEnable(GL_BLEND);
+        f->glBlendEquation(GL_FUNC_ADD);
+        f->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        f->glUseProgram(this->gl_Program);
+        f->glBindTexture(GL_TEXTURE_2D, this->gl_Texture);
+
+        f->glDrawArrays(GL_TRIANGLES, 0, this->gl_VertexCount);
+    }
+
+    // and put it all back
+    if (modern)
+    {
+        if (samplers)
+            ef->glBindSampler(0, sampler);
+        ef->glBindVertexArray(vertexArray);
+        ef->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+        ef->glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    }
+    else
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            f->glBindBuffer(GL_ARRAY_BUFFER, attribBuffer[i]);
+            f->glVertexAttribPointer(i, attribSize[i], attribType[i], attribNormalized[i], attribStride[i],
+                                     attribPointer[i]);
+            if (attribEnabled[i])
+                f->glEnableVertexAttribArray(i);
+            else
+                f->glDisableVertexAttribArray(i);
+        }
+
+        f->glBindFramebuffer(GL_FRAMEBUFFER, drawFramebuffer);
+    }
+
+    f->glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+    f->glBindTexture(GL_TEXTURE_2D, texture);
+    f->glActiveTexture(activeTexture);
+    f->glUseProgram(program);
+    f->glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    f->glBlendEquationSeparate(blendEquationRgb, blendEquationAlpha);
+    f->glBlendFuncSeparate(blendSrcRgb, blendDstRgb, blendSrcAlpha, blendDstAlpha);
+
+    auto setEnabled = [f](GLenum capability, GLboolean enabled) {
+        if (enabled)
+            f->glEnable(capability);
+        else
+            f->glDisable(capability);
+    };
+    setEnabled(GL_BLEND, blend);
+    setEnabled(GL_DEPTH_TEST, depthTest);
+    setEnabled(GL_SCISSOR_TEST, scissorTest);
+    setEnabled(GL_STENCIL_TEST, stencilTest);
+    setEnabled(GL_CULL_FACE, cullFace);
+}
+
+QString OGLTextOverlay::GetLastError(void)
+{
+    return this->error_Message;
+}
+
+bool OGLTextOverlay::gl_Init(QOpenGLContext *context)
+{
+    QOpenGLFunctions *f = context->functions();
+    QOpenGLExtraFunctions *ef = context->extraFunctions();
+    QByteArray vertexHeader, fragmentHeader;
+    GLint status = 0;
+    GLint unpackAlignment, unpackRowLength = 0, unpackBuffer = 0;
+
+    // objects of the previous context died with it
+    this->gl_Program = 0;
+    this->gl_Texture = 0;
+    this->gl_Buffer = 0;
+    this->gl_VertexArray = 0;
+    this->gl_VertexCount = 0;
+
+    if (context->isOpenGLES())
+    {
+        vertexHeader = this->gl_Modern ? "#version 300 es\n" : "#version 100\n";
+        fragmentHeader = vertexHeader + "precision mediump float;\n";
+    }
+    else
+    {
+        vertexHeader = this->gl_Modern ? "#version 150\n" : "#version 120\n";
+        fragmentHeader = vertexHeader;
+    }
+
+    if (this->gl_Modern)
+    {
+        vertexHeader += "#define ATTRIBUTE in\n#define VARYING out\n";
+        fragmentHeader += "#define VARYING in\n#define TEXTURE texture\nout vec4 FRAG_COLOR;\n";
+    }
+    else
+    {
+        vertexHeader += "#define ATTRIBUTE attribute\n#define VARYING varying\n";
+        fragmentHeader += "#define VARYING varying\n#define TEXTURE texture2D\n#define FRAG_COLOR gl_FragColor\n";
+    }
+
+    GLuint vertexShader = this->gl_Compile(context, GL_VERTEX_SHADER, vertexHeader + vertexSource);
+    GLuint fragmentShader = this->gl_Compile(context, GL_FRAGMENT_SHADER, fragmentHeader + fragmentSource);
+    if (vertexShader == 0 || fragmentShader == 0)
+    {
+        f->glDeleteShader(vertexShader);
+        f->glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    this->gl_Program = f->glCreateProgram();
+    f->glAttachShader(this->gl_Program, vertexShader);
+    f->glAttachShader(this->gl_Program, fragmentShader);
+    f->glBindAttribLocation(this->gl_Program, 0, "a_Position");
+    f->glBindAttribLocation(this->gl_Program, 1, "a_TexCoord");
+    f->glBindAttribLocation(this->gl_Program, 2, "a_Color");
+    f->glLinkProgram(this->gl_Program);
+    f->glDeleteShader(vertexShader);
+    f->glDeleteShader(fragmentShader);
+
+    f->glGetProgramiv(this->gl_Program, GL_LINK_STATUS, &status);
+    if (!status)
+    {
+        char log[512] = {0};
+        f->glGetProgramInfoLog(this->gl_Program, sizeof(log) - 1, nullptr, log);
+        this->error_Message = "OGLTextOverlay::gl_Init: glLinkProgram Failed: " + QString(log);
+        f->glDeleteProgram(this->gl_Program);
+        this->gl_Program = 0;
+        return false;
+    }
+
+    // the caller restores the program binding
+    f->glUseProgram(this->gl_Program);
+    f->glUniform1i(f->glGetUniformLocation(this->gl_Program, "u_Texture"), 0);
+
+    f->glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    if (this->gl_Modern)
+    {
+        f->glGetIntegerv(GL_UNPACK_ROW_LENGTH, &unpackRowLength);
+        f->glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+        f->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    f->glGenTextures(1, &this->gl_Texture);
+    f->glBindTexture(GL_TEXTURE_2D, this->gl_Texture);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->atlas_Image.width(), this->atlas_Image.height(), 0, GL_RGBA,
+                    GL_UNSIGNED_BYTE, this->atlas_Image.constBits());
+
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+    if (this->gl_Modern)
+    {
+        f->glPixelStorei(GL_UNPACK_ROW_LENGTH, unpackRowLength);
+        f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+    }
+
+    f->glGenBuffers(1, &this->gl_Buffer);
+
+    if (this->gl_Modern)
+    {
+        ef->glGenVertexArrays(1, &this->gl_VertexArray);
+        ef->glBindVertexArray(this->gl_VertexArray);
+        f->glBindBuffer(GL_ARRAY_BUFFER, this->gl_Buffer);
+        for (int i = 0; i < 3; i++)
+            f->glEnableVertexAttribArray(i);
+        f->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float), (void *)0);
+        f->glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float),
+                                 (void *)(2 * sizeof(float)));
+        f->glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, OGLTEXTOVERLAY_VERTEX_SIZE * sizeof(float),
+                                 (void *)(4 * sizeof(float)));
+    }
+
+    return true;
+}
+
+GLuint OGLTextOverlay::gl_Compile(QOpenGLContext *context, GLenum type, QByteArray source)
+{
+    QOpenGLFunctions *f = context->functions();
+    const char *data = source.constData();
+    GLint status = 0;
+
+    GLuint shader = f->glCreateShader(type);
+    f->glShaderSource(shader, 1, &data, nullptr);
+    f->glCompileShader(shader);
+
+    f->glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status)
+    {
+        char log[512] = {0};
+        f->glGetShaderInfoLog(shader, sizeof(log) - 1, nullptr, log);
+        this->error_Message = "OGLTextOverlay::gl_Compile: glCompileShader Failed: " + QString(log);
+        f->glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+void OGLTextOverlay::gl_Build(QOpenGLContext *context)
+{
+    QVector<float> vertices;
+    QStringList lines = this->gl_Text.split('\n');
+    float width = this->gl_Size.width();
+    float height = this->gl_Size.height();
+    float atlasWidth = this->atlas_Image.width();
+    float atlasHeight = this->atlas_Image.height();
+    int scale = qMax(1, this->gl_Size.height() / 540);
+    int cellWidth = this->atlas_Cell.width();
+    int cellHeight = this->atlas_Cell.height();
+    int margin = 8 * scale;
+    int padding = 4 * scale;
+    int textWidth = 0;
+
+    // pixels from the top left to normalized device coordinates
+    auto quad = [&](float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float r, float g,
+                    float b, float a) {
+        float corners[6][4] = {{x0, y0, u0, v0}, {x1, y0, u1, v0}, {x0, y1, u0, v1},
+                               {x1, y0, u1, v0}, {x1, y1, u1, v1}, {x0, y1, u0, v1}};
+        for (const auto &corner : corners)
+        {
+            vertices << (corner[0] * 2.0f / width) - 1.0f << 1.0f - (corner[1] * 2.0f / height);
+            vertices << corner[2] << corner[3] << r << g << b << a;
+        }
+    };
+
+    for (const QString &line : lines)
+    {
+        int lineWidth = 0;
+        for (const QChar &c : line)
+        {
+            int index = (c.unicode() >= 32 && c.unicode() < 127) ? c.unicode() - 32 : '?' - 32;
+            lineWidth += this->atlas_Advance[index] * scale;
+        }
+        textWidth = qMax(textWidth, lineWidth);
+    }
+
+    // translucent background, sampled from the middle of the solid block
+    int block = OGLTEXTOVERLAY_GLYPHS - 1;
+    float blockU = (((block % OGLTEXTOVERLAY_COLUMNS) * cellWidth) + (cellWidth / 2.0f)) / atlasWidth;
+    float blockV = (((block / OGLTEXTOVERLAY_COLUMNS) * cellHeight) + (cellHeight / 2.0f)) / atlasHeight;
+    quad(margin - padding, margin - padding, margin + textWidth + padding,
+         margin + (lines.size() * (cellHeight - 2) * scale) + padding, blockU, blockV, blockU, blockV, 0, 0, 0, 0.5f);
+
+    for (int i = 0; i < lines.size(); i++)
+    {
+        float x = margin;
+        float y = margin + (i * (cellHeight - 2) * scale);
+
+        for (const QChar &c : lines.at(i))
+        {
+            int index = (c.unicode() >= 32 && c.unicode() < 127) ? c.unicode() - 32 : '?' - 32;
+            float u = (index % OGLTEXTOVERLAY_COLUMNS) * cellWidth;
+            float v = (index / OGLTEXTOVERLAY_COLUMNS) * cellHeight;
+
+            if (c != ' ')
+            {
+                // the glyph starts one pixel into its cell
+                quad(x - scale, y - scale, x - scale + (cellWidth * scale), y - scale + (cellHeight * scale),
+                     u / atlasWidth, v / atlasHeight, (u + cellWidth) / atlasWidth, (v + cellHeight) / atlasHeight, 1,
+                     1, 1, 1);
+            }
+
+            x += this->atlas_Advance[index] * scale;
+        }
+    }
+
+    context->functions()->glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.constData(),
+                                       GL_DYNAMIC_DRAW);
+    this->gl_VertexCount = vertices.size() / OGLTEXTOVERLAY_VERTEX_SIZE;
+}
@@ -0,0 +1,86 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef OGLTEXTOVERLAY_HPP
+#define OGLTEXTOVERLAY_HPP
+
+#include <QImage>
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+// printable ASCII plus one solid block for the background
+#define OGLTEXTOVERLAY_GLYPHS 96
+#define OGLTEXTOVERLAY_COLUMNS 16
+
+namespace UserInterface
+{
+namespace Widget
+{
+// Draws a few lines of text over whatever is in a framebuffer,
+// the glyphs come from a texture atlas built once from a font file,
+// so a frame costs one draw call, the vertices only get rebuilt
+// when the text changes. Every bit of GL state it touches gets restored,
+// which makes it safe to use on the video plugin's context
+class OGLTextOverlay
+{
+  public:
+    OGLTextOverlay(void);
+    ~OGLTextOverlay(void);
+
+    // GUI thread
+    bool Init(QString, int);
+    void SetEnabled(bool);
+    bool IsEnabled(void);
+
+    // any thread
+    void SetText(QString);
+
+    // render thread, context must be current
+    void Render(QOpenGLContext *, GLuint, QSize);
+
+    QString GetLastError(void);
+
+  private:
+    QString error_Message;
+
+    std::atomic<bool> overlay_Enabled{false};
+
+    std::atomic<bool> atlas_Valid{false};
+    QImage atlas_Image;
+    QSize atlas_Cell;
+    int atlas_Advance[OGLTEXTOVERLAY_GLYPHS] = {0};
+
+    QMutex text_Mutex;
+    QString text_String;
+    bool text_Changed = false;
+
+    QOpenGLContext *gl_Context = nullptr;
+    bool gl_Valid = false;
+    bool gl_Modern = false;
+    GLuint gl_Program = 0;
+    GLuint gl_Texture = 0;
+    GLuint gl_Buffer = 0;
+    GLuint gl_VertexArray = 0;
+    QString gl_Text;
+    QSize gl_Size;
+    int gl_VertexCount = 0;
+
+    bool gl_Init(QOpenGLContext *);
+    GLuint gl_Compile(QOpenGLContext *, GLenum, QByteArray);
+    void gl_Build(QOpenGLContext *);
+};
+} // namespace Widget
+} // namespace UserInterface
+
+#endif // OGLTEXTOVERLAY_HPP
@@ -1,11 +1,16 @@
 #include "OGLWidget.hpp"
 #include "../../Globals.hpp"
+#include "../../Utilities/OpenGLContext.hpp"
+
+#include <QDeadlineTimer>
+#include <QGuiApplication>
+#include <QMutexLocker>
 
 using namespace UserInterface::Widget;
 
 #include <iostream>
 
-OGLWidget::OGLWidget(QWidget *parent)
+OGLWidget::OGLWidget(QWidget *parent) : QOpenGLWindow(QOpenGLContext::globalShareContext())
 {
     this->parent = parent;
     this->timerId = 0;
@@ -15,15 +20,64 @@ OGLWidget::~OGLWidget(void)
 {
 }
 
-void OGLWidget::SetThread(QThread *thread)
+void OGLWidget::PrepareContext(QSurfaceFormat format, QString owner)
 {
+    QOpenGLContext *context = this->context();
+
+    // re-use the context from the previous session when
+    // the format and GFX plugin are the same, a different
+    // plugin gets a fresh one, otherwise we'll get some funky colors
+    this->context_Reused = this->context_Created.isValid() && context->isValid() && this->context_Owner == owner &&
+                           Utilities::OpenGLFormatMatches(this->context_Format, format);
+    this->context_Sessions++;
+
+    if (this->context_Reused)
+        return;
+
     this->doneCurrent();
 
-    // Does this leak?
-    // seems to be needed for GFX plugin switching
-    // otherwise we'll get some funky colors
-    this->context()->create();
+    context->setFormat(format);
+    context->create();
+
+    this->context_Format = format;
+    this->context_Owner = owner;
+    this->context_Created.start();
+    this->context_Sessions = 1;
+    this->context_Memory = -1;
+}
+
+void OGLWidget::ResetContextState(void)
+{
+    QOpenGLContext *context = this->GetRenderContext();
+
+    if (this->context_Reused)
+        Utilities::OpenGLResetState(context);
+
+    if (this->context_Memory == -1)
+        this->context_Memory = Utilities::OpenGLGetFreeMemory(context);
+}
+
+QString OGLWidget::GetContextDiagnostics(void)
+{
+    QString diagnostics;
+    int memory = Utilities::OpenGLGetFreeMemory(this->GetRenderContext());
+
+    diagnostics = this->context_Reused ? "re-used" : "created";
+    diagnostics += " OpenGL context, " + QString::number(this->context_Created.elapsed() / 1000) + "s old";
+    diagnostics += ", " + QString::number(this->context_Sessions) + " session(s)";
+
+    if (memory != -1 && this->context_Memory != -1)
+    {
+        diagnostics += ", " + QString::number(memory / 1024) + "MiB video memory free";
+        diagnostics += " (" + QString::number((this->context_Memory - memory) / 1024) + "MiB used since creation)";
+    }
 
+    return diagnostics;
+}
+
+void OGLWidget::SetThread(QThread *thread)
+{
+    this->doneCurrent();
     this->context()->moveToThread(thread);
 }
 
@@ -32,13 +86,93 @@ void OGLWidget::SetAllowResizing(bool allow)
     this->allowResizing = allow;
 }
 
+bool OGLWidget::WaitForValid(int timeout)
+{
+    QMutexLocker locker(&this->valid_Mutex);
+    QDeadlineTimer deadline(timeout);
+
+    // the GUI thread wakes us up from initializeGL()
+    while (!this->isValid())
+    {
+        if (!this->valid_Condition.wait(&this->valid_Mutex, deadline))
+            return this->isValid();
+    }
+
+    return true;
+}
+
+void OGLWidget::SetOffscreen(bool enabled)
+{
+    this->offscreen_Enabled = enabled;
+}
+
+void OGLWidget::SetScaleOnResize(bool enabled, bool integer)
+{
+    this->scale_Enabled = enabled;
+    this->scale_Integer = integer;
+}
+
+bool OGLWidget::IsOffscreen(void)
+{
+    return this->offscreen_Enabled;
+}
+
+OGLFrameQueue *OGLWidget::GetFrameQueue(void)
+{
+    return &this->offscreen_Queue;
+}
+
+QOpenGLContext *OGLWidget::GetRenderContext(void)
+{
+    if (this->offscreen_Enabled)
+        return this->offscreen_Queue.GetContext();
+
+    return this->context();
+}
+
+OGLTextOverlay *OGLWidget::GetTextOverlay(void)
+{
+    return &this->text_Overlay;
+}
+
 QWidget *OGLWidget::GetWidget(void)
 {
     QWidget *widget = QWidget::createWindowContainer(this);
     widget->setParent(this->parent);
+    this->embedded = true;
     return widget;
 }
 
+bool OGLWidget::IsEmbedded(void)
+{
+    return this->embedded;
+}
+
+void OGLWidget::initializeGL(void)
+{
+    QMutexLocker locker(&this->valid_Mutex);
+    this->valid_Condition.wakeAll();
+}
+
+void OGLWidget::paintGL(void)
+{
+    if (!this->offscreen_Enabled)
+        return;
+
+    // present the latest finished frame, scaled to the window,
+    // swapBuffers() afterwards waits for vsync on the GUI thread
+    // so the render thread never blocks on the compositor
+    QSize size = this->size() * this->devicePixelRatio();
+    if (!this->offscreen_Queue.Present(this->context(), this->defaultFramebufferObject(), size,
+                                       this->scale_Enabled && this->scale_Integer))
+    {
+        this->context()->functions()->glClearColor(0, 0, 0, 1);
+        this->context()->functions()->glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    this->text_Overlay.Render(this->context(), this->defaultFramebufferObject(), size);
+}
+
 void OGLWidget::exposeEvent(QExposeEvent *)
 {
 }
@@ -47,6 +181,10 @@ void OGLWidget::resizeEvent(QResizeEvent *event)
 {
     QOpenGLWindow::resizeEvent(event);
 
+    // the latest frame gets scaled to the new size right away
+    if (this->offscreen_Enabled)
+        this->update();
+
     if (!this->allowResizing)
         return;
 
@@ -56,13 +194,19 @@ void OGLWidget::resizeEvent(QResizeEvent *event)
         this->timerId = 0;
     }
 
-    this->timerId = this->startTimer(100);
+    // changing the video size makes the plugin rebuild its framebuffers,
+    // when scaling we only do that once the resize has settled
+    this->timerId = this->startTimer(this->scale_Enabled ? APP_RESIZE_SETTLE_TIME : 100);
     this->width = event->size().width() * this->devicePixelRatio();
     this->height = event->size().height() * this->devicePixelRatio();
 }
 
 void OGLWidget::timerEvent(QTimerEvent *event)
 {
+    // still dragging the window edge
+    if (this->scale_Enabled && QGuiApplication::mouseButtons() != Qt::NoButton)
+        return;
+
     g_MupenApi.Core.SetVideoSize(this->width, this->height);
 
     // remove current timer
@@ -1,11 +1,17 @@
 #ifndef OGLWIDGET_HPP
 #define OGLWIDGET_HPP
 
+#include "OGLFrameQueue.hpp"
+#include "OGLTextOverlay.hpp"
+
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QOpenGLWidget>
 #include <QOpenGLWindow>
 #include <QResizeEvent>
 #include <QThread>
 #include <QTimerEvent>
+#include <QWaitCondition>
 #include <QWidget>
 
 namespace UserInterface
@@ -18,12 +24,28 @@ class OGLWidget : public QOpenGLWindow
     OGLWidget(QWidget *);
     ~OGLWidget(void);
 
+    void PrepareContext(QSurfaceFormat, QString);
+    void ResetContextState(void);
+    QString GetContextDiagnostics(void);
+
     void SetThread(QThread *);
     void SetAllowResizing(bool);
 
+    bool WaitForValid(int);
+
+    void SetOffscreen(bool);
+    void SetScaleOnResize(bool, bool);
+    bool IsOffscreen(void);
+    OGLFrameQueue *GetFrameQueue(void);
+    QOpenGLContext *GetRenderContext(void);
+    OGLTextOverlay *GetTextOverlay(void);
+
     QWidget *GetWidget(void);
+    bool IsEmbedded(void);
 
   protected:
+    void initializeGL(void) Q_DECL_OVERRIDE;
+    void paintGL(void) Q_DECL_OVERRIDE;
     void exposeEvent(QExposeEvent *) Q_DECL_OVERRIDE;
     void resizeEvent(QResizeEvent *) Q_DECL_OVERRIDE;
     void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE;
@@ -34,6 +56,25 @@ class OGLWidget : public QOpenGLWindow
     int width;
     int height;
     int timerId;
+
+    QSurfaceFormat context_Format;
+    QString context_Owner;
+    QElapsedTimer context_Created;
+    int context_Sessions = 0;
+    int context_Memory = -1;
+    bool context_Reused = false;
+
+    QMutex valid_Mutex;
+    QWaitCondition valid_Condition;
+
+    bool embedded = false;
+
+    bool offscreen_Enabled = false;
+    bool scale_Enabled = false;
+    bool scale_Integer = false;
+    OGLFrameQueue offscreen_Queue;
+
+    OGLTextOverlay text_Overlay;
 };
 } // namespace Widget
 } // namespace UserInterface
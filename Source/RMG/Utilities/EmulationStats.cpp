@@ -0,0 +1,90 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "EmulationStats.hpp"
+
+using namespace Utilities;
+
+EmulationStats::EmulationStats(void)
+{
+}
+
+EmulationStats::~EmulationStats(void)
+{
+}
+
+void EmulationStats::Reset(double targetRate)
+{
+    this->target_Rate = targetRate;
+    this->sample_Timer.invalidate();
+    this->stats_Fps = 0;
+    this->stats_ViRate = 0;
+    this->stats_CpuUsage = -1;
+}
+
+void EmulationStats::Sample(quint64 viCount, quint32 frameCount, qint64 cpuTime)
+{
+    if (this->sample_Timer.isValid())
+    {
+        double elapsed = this->sample_Timer.nsecsElapsed() / 1000000000.0;
+
+        // the counters restart with every emulation session
+        if (elapsed > 0 && viCount >= this->sample_ViCount && frameCount >= this->sample_FrameCount)
+        {
+            this->stats_ViRate = (viCount - this->sample_ViCount) / elapsed;
+            this->stats_Fps = (frameCount - this->sample_FrameCount) / elapsed;
+
+            if (cpuTime >= 0 && this->sample_CpuTime >= 0 && cpuTime >= this->sample_CpuTime)
+                this->stats_CpuUsage = ((cpuTime - this->sample_CpuTime) / 10000000.0) / elapsed;
+            else
+                this->stats_CpuUsage = -1;
+        }
+    }
+
+    this->sample_Timer.start();
+    this->sample_ViCount = viCount;
+    this->sample_FrameCount = frameCount;
+    this->sample_CpuTime = cpuTime;
+}
+
+double EmulationStats::GetFps(void)
+{
+    return this->stats_Fps;
+}
+
+double EmulationStats::GetViRate(void)
+{
+    return this->stats_ViRate;
+}
+
+double EmulationStats::GetTargetRate(void)
+{
+    return this->target_Rate;
+}
+
+double EmulationStats::GetSpeed(void)
+{
+    return (this->stats_ViRate * 100.0) / this->target_Rate;
+}
+
+double EmulationStats::GetCpuUsage(void)
+{
+    return this->stats_CpuUsage;
+}
+
+QString EmulationStats::GetSummary(void)
+{
+    QString summary;
+    summary += QString::number(this->stats_Fps, 'f', 1) + " FPS";
+    summary += "  " + QString::number(this->stats_ViRate, 'f', 1) + " VI/s";
+    summary += "  " + QString::number(this->GetSpeed(), 'f', 0) + "%";
+    if (this->stats_CpuUsage >= 0)
+        summary += "  CPU " + QString::number(this->stats_CpuUsage, 'f', 0) + "%";
+    return summary;
+}
@@ -0,0 +1,52 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef EMULATIONSTATS_HPP
+#define EMULATIONSTATS_HPP
+
+#include <QElapsedTimer>
+#include <QString>
+
+namespace Utilities
+{
+// Turns the counters the emulation and render threads
+// keep into rates, sampled periodically by the GUI thread
+class EmulationStats
+{
+  public:
+    EmulationStats(void);
+    ~EmulationStats(void);
+
+    void Reset(double);
+
+    // VI count, rendered frame count, cpu time in ns (-1 when unknown)
+    void Sample(quint64, quint32, qint64);
+
+    double GetTargetRate(void);
+    double GetFps(void);
+    double GetViRate(void);
+    double GetSpeed(void);
+    double GetCpuUsage(void);
+    QString GetSummary(void);
+
+  private:
+    QElapsedTimer sample_Timer;
+    quint64 sample_ViCount = 0;
+    quint32 sample_FrameCount = 0;
+    qint64 sample_CpuTime = -1;
+
+    double target_Rate = 60.0;
+
+    double stats_Fps = 0;
+    double stats_ViRate = 0;
+    double stats_CpuUsage = -1;
+};
+} // namespace Utilities
+
+#endif // EMULATIONSTATS_HPP
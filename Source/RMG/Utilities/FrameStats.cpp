@@ -0,0 +1,136 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FrameStats.hpp"
+
+using namespace Utilities;
+
+FrameStats::FrameStats(void)
+{
+    this->refresh_Period = 0;
+    this->Reset();
+}
+
+FrameStats::~FrameStats(void)
+{
+}
+
+void FrameStats::Reset(void)
+{
+    for (int i = 0; i < FRAMESTATS_RING_SIZE; i++)
+        this->ring[i].store(0, std::memory_order_relaxed);
+
+    for (int i = 0; i <= FRAMESTATS_BUCKET_COUNT; i++)
+        this->bucket[i].store(0, std::memory_order_relaxed);
+
+    this->frame_Count.store(0, std::memory_order_relaxed);
+    this->frame_Dropped.store(0, std::memory_order_relaxed);
+    this->frame_Duplicated.store(0, std::memory_order_relaxed);
+    this->frame_Total.store(0, std::memory_order_relaxed);
+    this->swap_Total.store(0, std::memory_order_relaxed);
+    this->ring_Position.store(0, std::memory_order_release);
+}
+
+void FrameStats::SetRefreshRate(double rate)
+{
+    if (rate <= 0)
+        return;
+
+    this->refresh_Period.store((qint64)(1000000000.0 / rate), std::memory_order_relaxed);
+}
+
+void FrameStats::AddFrame(qint64 interval, qint64 swap)
+{
+    quint32 position = this->ring_Position.load(std::memory_order_relaxed);
+    qint64 period = this->refresh_Period.load(std::memory_order_relaxed);
+    int index = (int)(interval / FRAMESTATS_BUCKET_SIZE);
+
+    this->ring[position % FRAMESTATS_RING_SIZE].store(interval, std::memory_order_relaxed);
+    this->ring_Position.store(position + 1, std::memory_order_release);
+
+    this->bucket[qMin(index, FRAMESTATS_BUCKET_COUNT)].fetch_add(1, std::memory_order_relaxed);
+
+    // two swaps within half a refresh means one of them never got shown,
+    // every extra refresh a swap takes shows the previous frame again
+    if (period > 0)
+    {
+        if (interval < (period / 2))
+            this->frame_Dropped.fetch_add(1, std::memory_order_relaxed);
+        else if (interval > (period + (period / 2)))
+            this->frame_Duplicated.fetch_add((quint32)((interval - (period / 2)) / period),
+                                             std::memory_order_relaxed);
+    }
+
+    this->frame_Count.fetch_add(1, std::memory_order_relaxed);
+    this->frame_Total.fetch_add(interval, std::memory_order_relaxed);
+    this->swap_Total.fetch_add(swap, std::memory_order_relaxed);
+}
+
+quint32 FrameStats::GetFrameCount(void)
+{
+    return this->frame_Count.load(std::memory_order_relaxed);
+}
+
+int FrameStats::GetRecentFrames(qint64 *frames, int max)
+{
+    quint32 position = this->ring_Position.load(std::memory_order_acquire);
+    int count = qMin(max, (int)qMin(position, (quint32)FRAMESTATS_RING_SIZE));
+
+    // oldest first
+    for (int i = 0; i < count; i++)
+    {
+        quint32 index = position - count + i;
+        frames[i] = this->ring[index % FRAMESTATS_RING_SIZE].load(std::memory_order_relaxed);
+    }
+
+    return count;
+}
+
+double FrameStats::GetPercentile(double percentile)
+{
+    quint32 count = this->frame_Count.load(std::memory_order_relaxed);
+    quint32 target = (quint32)(count * percentile);
+    quint32 total = 0;
+
+    if (count == 0)
+        return 0;
+
+    for (int i = 0; i <= FRAMESTATS_BUCKET_COUNT; i++)
+    {
+        total += this->bucket[i].load(std::memory_order_relaxed);
+        if (total > target)
+            return ((i + 0.5) * FRAMESTATS_BUCKET_SIZE) / 1000000.0;
+    }
+
+    return ((double)FRAMESTATS_BUCKET_COUNT * FRAMESTATS_BUCKET_SIZE) / 1000000.0;
+}
+
+double FrameStats::GetRefreshPeriod(void)
+{
+    return this->refresh_Period.load(std::memory_order_relaxed) / 1000000.0;
+}
+
+QString FrameStats::GetSummary(void)
+{
+    quint32 count = this->frame_Count.load(std::memory_order_relaxed);
+    qint64 frameTotal = this->frame_Total.load(std::memory_order_relaxed);
+    qint64 swapTotal = this->swap_Total.load(std::memory_order_relaxed);
+
+    if (count == 0 || frameTotal == 0)
+        return "no frames";
+
+    QString summary;
+    summary += QString::number(count) + " frames";
+    summary += ", p50 " + QString::number(this->GetPercentile(0.50), 'f', 2) + "ms";
+    summary += ", p99 " + QString::number(this->GetPercentile(0.99), 'f', 2) + "ms";
+    summary += ", " + QString::number(this->frame_Dropped.load(std::memory_order_relaxed)) + " dropped";
+    summary += ", " + QString::number(this->frame_Duplicated.load(std::memory_order_relaxed)) + " duplicated";
+    summary += ", " + QString::number((swapTotal * 100.0) / frameTotal, 'f', 1) + "% blocked in swap";
+    return summary;
+}
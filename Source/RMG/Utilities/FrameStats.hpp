@@ -0,0 +1,61 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FRAMESTATS_HPP
+#define FRAMESTATS_HPP
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+
+#define FRAMESTATS_RING_SIZE 512
+#define FRAMESTATS_BUCKET_SIZE 250000 // 0.25ms
+#define FRAMESTATS_BUCKET_COUNT 400   // up to 100ms
+
+namespace Utilities
+{
+// Lock-free frame time statistics,
+// written by the render thread only,
+// read by any thread
+class FrameStats
+{
+  public:
+    FrameStats(void);
+    ~FrameStats(void);
+
+    void Reset(void);
+    void SetRefreshRate(double);
+
+    // render thread
+    void AddFrame(qint64, qint64);
+
+    quint32 GetFrameCount(void);
+    int GetRecentFrames(qint64 *, int);
+    double GetPercentile(double);
+    double GetRefreshPeriod(void);
+    QString GetSummary(void);
+
+  private:
+    std::atomic<qint64> ring[FRAMESTATS_RING_SIZE];
+    std::atomic<quint32> ring_Position;
+
+    std::atomic<quint32> bucket[FRAMESTATS_BUCKET_COUNT + 1];
+
+    std::atomic<qint64> refresh_Period;
+
+    std::atomic<quint32> frame_Count;
+    std::atomic<quint32> frame_Dropped;
+    std::atomic<quint32> frame_Duplicated;
+    std::atomic<qint64> frame_Total;
+    std::atomic<qint64> swap_Total;
+};
+} // namespace Utilities
+
+#endif // FRAMESTATS_HPP
@@ -0,0 +1,99 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "OpenGLContext.hpp"
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFunctions>
+
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+
+bool Utilities::OpenGLFormatMatches(QSurfaceFormat a, QSurfaceFormat b)
+{
+    return a.renderableType() == b.renderableType() && a.profile() == b.profile() &&
+           a.majorVersion() == b.majorVersion() && a.minorVersion() == b.minorVersion() &&
+           a.options() == b.options() && a.swapBehavior() == b.swapBehavior() && a.samples() == b.samples() &&
+           a.depthBufferSize() == b.depthBufferSize() && a.stencilBufferSize() == b.stencilBufferSize() &&
+           a.redBufferSize() == b.redBufferSize() && a.greenBufferSize() == b.greenBufferSize() &&
+           a.blueBufferSize() == b.blueBufferSize() && a.alphaBufferSize() == b.alphaBufferSize() &&
+           a.swapInterval() == b.swapInterval();
+}
+
+void Utilities::OpenGLResetState(QOpenGLContext *context)
+{
+    QOpenGLFunctions *f = context->functions();
+    GLint count = 0;
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, context->defaultFramebufferObject());
+    f->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    f->glUseProgram(0);
+    f->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    f->glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &count);
+    for (int i = 0; i < count; i++)
+        f->glDisableVertexAttribArray(i);
+
+    f->glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &count);
+    for (int i = 0; i < qMin(count, 32); i++)
+    {
+        f->glActiveTexture(GL_TEXTURE0 + i);
+        f->glBindTexture(GL_TEXTURE_2D, 0);
+        f->glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    }
+    f->glActiveTexture(GL_TEXTURE0);
+
+    if (context->format().majorVersion() >= 3)
+    {
+        QOpenGLExtraFunctions *ef = context->extraFunctions();
+        ef->glBindVertexArray(0);
+        ef->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        ef->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        ef->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    f->glDisable(GL_BLEND);
+    f->glDisable(GL_CULL_FACE);
+    f->glDisable(GL_DEPTH_TEST);
+    f->glDisable(GL_POLYGON_OFFSET_FILL);
+    f->glDisable(GL_SCISSOR_TEST);
+    f->glDisable(GL_STENCIL_TEST);
+    f->glEnable(GL_DITHER);
+
+    f->glBlendEquation(GL_FUNC_ADD);
+    f->glBlendFunc(GL_ONE, GL_ZERO);
+    f->glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    f->glCullFace(GL_BACK);
+    f->glFrontFace(GL_CCW);
+    f->glDepthFunc(GL_LESS);
+    f->glDepthMask(GL_TRUE);
+    f->glStencilFunc(GL_ALWAYS, 0, 0xFFFFFFFF);
+    f->glStencilMask(0xFFFFFFFF);
+    f->glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    f->glPolygonOffset(0, 0);
+    f->glLineWidth(1);
+    f->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    f->glClearColor(0, 0, 0, 0);
+    f->glClearDepthf(1);
+    f->glClearStencil(0);
+}
+
+int Utilities::OpenGLGetFreeMemory(QOpenGLContext *context)
+{
+    GLint memory[4] = {-1, -1, -1, -1};
+
+    if (context->hasExtension("GL_NVX_gpu_memory_info"))
+        context->functions()->glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, memory);
+    else if (context->hasExtension("GL_ATI_meminfo"))
+        context->functions()->glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, memory);
+
+    return memory[0];
+}
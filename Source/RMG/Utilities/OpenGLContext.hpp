@@ -0,0 +1,31 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef OPENGLCONTEXT_HPP
+#define OPENGLCONTEXT_HPP
+
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+
+namespace Utilities
+{
+// whether a context created with the first format
+// can be reused for the second one
+bool OpenGLFormatMatches(QSurfaceFormat, QSurfaceFormat);
+
+// resets the state a previous session may have left behind,
+// context must be current
+void OpenGLResetState(QOpenGLContext *);
+
+// free video memory in KiB, -1 when unknown,
+// context must be current
+int OpenGLGetFreeMemory(QOpenGLContext *);
+} // namespace Utilities
+
+#endif // OPENGLCONTEXT_HPP
@@ -9,9 +9,13 @@
  */
 #include "Plugins.hpp"
 #include "../Globals.hpp"
+#include "../Thread/PluginProbeThread.hpp"
+#include "../Config.hpp"
 #include "Utilities/SettingsID.hpp"
 
+#include <QCoreApplication>
 #include <QDir>
+#include <QFile>
 
 using namespace Utilities;
 
@@ -25,41 +29,61 @@ Plugins::~Plugins()
 
 void Plugins::LoadSettings()
 {
-    SettingsID id;
+    PluginType types[] = {PluginType::Gfx, PluginType::Audio, PluginType::Input, PluginType::Rsp};
     QString settingValue;
-    for (const Plugin_t &p : this->GetAvailablePlugins())
+
+    // probe all plugins out-of-process in the background,
+    // so we only ever load the plugins we're told to use
+    this->probe_Start();
+
+    for (const PluginType &type : types)
     {
-        switch (p.Type)
+        settingValue = g_Settings.GetStringValue(this->plugin_GetSettingsID(type));
+
+        if (!settingValue.isEmpty() && QFile::exists(settingValue))
         {
-        default:
-        case PluginType::Gfx:
-            id = SettingsID::Core_GFX_Plugin;
-            break;
-        case PluginType::Rsp:
-            id = SettingsID::Core_RSP_Plugin;
-            break;
-        case PluginType::Audio:
-            id = SettingsID::Core_AUDIO_Plugin;
-            break;
-        case PluginType::Input:
-            id = SettingsID::Core_INPUT_Plugin;
-            break;
+            Plugin_t plugin = {.FileName = settingValue, .Type = type};
+            if (g_MupenApi.Core.SetPlugin(plugin))
+                continue;
         }
 
-        settingValue = g_Settings.GetStringValue(id);
-        if (settingValue == p.FileName || settingValue.isEmpty())
-            this->ChangePlugin(p);
+        // no (usable) plugin in the settings, fallback to the first
+        // working plugin the probe found, once it's done
+        if (this->probe_Done)
+            this->plugin_Fallback(type);
+        else
+            this->plugin_FallbackTodo.append(type);
     }
 }
 
+void Plugins::WaitForProbe(void)
+{
+    if (this->probe_Done || this->probe_Thread == nullptr)
+        return;
+
+    this->probe_Thread->wait();
+    this->on_ProbeThread_Finished();
+}
+
+bool Plugins::IsProbeDone(void)
+{
+    return this->probe_Done;
+}
+
 QList<Plugin_t> Plugins::GetAvailablePlugins()
+{
+    return this->plugin_List;
+}
+
+QList<Plugin_t> Plugins::GetAvailablePlugins(PluginType type)
 {
     QList<Plugin_t> plugins;
 
-    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Gfx));
-    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Rsp));
-    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Audio));
-    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Input));
+    for (const Plugin_t &p : this->GetAvailablePlugins())
+    {
+        if (p.Type == type)
+            plugins.append(p);
+    }
 
     return plugins;
 }
@@ -70,27 +94,7 @@ bool Plugins::ChangePlugin(Plugin_t plugin)
     ret = g_MupenApi.Core.SetPlugin(plugin);
 
     if (ret)
-    {
-        SettingsID id;
-        switch (plugin.Type)
-        {
-        default:
-        case PluginType::Gfx:
-            id = SettingsID::Core_GFX_Plugin;
-            break;
-        case PluginType::Rsp:
-            id = SettingsID::Core_RSP_Plugin;
-            break;
-        case PluginType::Audio:
-            id = SettingsID::Core_AUDIO_Plugin;
-            break;
-        case PluginType::Input:
-            id = SettingsID::Core_INPUT_Plugin;
-            break;
-        }
-
-        g_Settings.SetValue(id, plugin.FileName);
-    }
+        g_Settings.SetValue(this->plugin_GetSettingsID(plugin.Type), plugin.FileName);
 
     return ret;
 }
@@ -100,4 +104,92 @@ Plugin_t Plugins::GetCurrentPlugin(PluginType type)
     Plugin_t plugin = {0};
     g_MupenApi.Core.GetCurrentPlugin(type, &plugin);
     return plugin;
-}
\ No newline at end of file
+}
+
+void Plugins::probe_Start(void)
+{
+    QString probeFile = QCoreApplication::applicationDirPath() + "/" APP_PLUGINPROBE_FILE;
+
+    if (this->probe_Thread != nullptr && this->probe_Thread->isRunning())
+        return;
+
+    this->probe_Done = false;
+
+    // the in-process fallback calls into the core,
+    // so it has to stay on our thread
+    if (!QFile::exists(probeFile))
+    {
+        this->probe_InProcess();
+        return;
+    }
+
+    if (this->probe_Thread == nullptr)
+    {
+        this->probe_Thread = new Thread::PluginProbeThread();
+        connect(this->probe_Thread, &QThread::finished, this, &Plugins::on_ProbeThread_Finished,
+                Qt::QueuedConnection);
+    }
+
+    this->probe_Thread->start();
+}
+
+void Plugins::probe_InProcess(void)
+{
+    QList<Plugin_t> plugins;
+
+    g_Logger.AddText("Plugins::probe_InProcess: " APP_PLUGINPROBE_FILE " not found, probing in-process");
+
+    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Gfx));
+    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Rsp));
+    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Audio));
+    plugins.append(g_MupenApi.Core.GetPlugins(PluginType::Input));
+
+    this->probe_Finish(plugins);
+}
+
+void Plugins::probe_Finish(QList<Plugin_t> plugins)
+{
+    this->plugin_List = plugins;
+    this->probe_Done = true;
+
+    for (const PluginType &type : this->plugin_FallbackTodo)
+        this->plugin_Fallback(type);
+    this->plugin_FallbackTodo.clear();
+
+    emit this->on_Plugins_Probed();
+}
+
+void Plugins::plugin_Fallback(PluginType type)
+{
+    for (const Plugin_t &p : this->GetAvailablePlugins(type))
+    {
+        if (this->ChangePlugin(p))
+            break;
+    }
+}
+
+void Plugins::on_ProbeThread_Finished(void)
+{
+    // WaitForProbe() may have beaten
+    // the queued finished signal
+    if (this->probe_Done || this->probe_Thread->isRunning())
+        return;
+
+    this->probe_Finish(this->probe_Thread->GetPlugins());
+}
+
+SettingsID Plugins::plugin_GetSettingsID(PluginType type)
+{
+    switch (type)
+    {
+    default:
+    case PluginType::Gfx:
+        return SettingsID::Core_GFX_Plugin;
+    case PluginType::Rsp:
+        return SettingsID::Core_RSP_Plugin;
+    case PluginType::Audio:
+        return SettingsID::Core_AUDIO_Plugin;
+    case PluginType::Input:
+        return SettingsID::Core_INPUT_Plugin;
+    }
+}
@@ -11,26 +11,60 @@
 #define PLUGINS_HPP
 
 #include "M64P/Wrapper/Types.hpp"
+#include "Utilities/SettingsID.hpp"
 
 #include <QList>
+#include <QObject>
 
 using namespace M64P::Wrapper;
 
+namespace Thread
+{
+class PluginProbeThread;
+}
+
 namespace Utilities
 {
-class Plugins
+class Plugins : public QObject
 {
+    Q_OBJECT
+
   public:
     Plugins();
     ~Plugins();
 
     void LoadSettings();
 
+    // blocks until the probe is done, only for
+    // callers without an event loop
+    void WaitForProbe(void);
+    bool IsProbeDone(void);
+
+    // empty until on_Plugins_Probed has been emitted
     QList<Plugin_t> GetAvailablePlugins();
     QList<Plugin_t> GetAvailablePlugins(PluginType);
 
     bool ChangePlugin(Plugin_t);
     Plugin_t GetCurrentPlugin(PluginType);
+
+  private:
+    Thread::PluginProbeThread *probe_Thread = nullptr;
+    QList<Plugin_t> plugin_List;
+    QList<PluginType> plugin_FallbackTodo;
+    bool probe_Done = false;
+
+    void probe_Start(void);
+    void probe_InProcess(void);
+    void probe_Finish(QList<Plugin_t>);
+
+    void plugin_Fallback(PluginType);
+    SettingsID plugin_GetSettingsID(PluginType);
+
+  private slots:
+    void on_ProbeThread_Finished(void);
+
+  signals:
+    void on_Plugins_Probed(void);
 };
 }; // namespace Utilities
 
@@ -0,0 +1,52 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Profiler.hpp"
+
+using namespace Utilities;
+
+Profiler::Profiler(void)
+{
+}
+
+Profiler::~Profiler(void)
+{
+}
+
+void Profiler::Start(void)
+{
+    this->phase_List.clear();
+    this->phase_Start = 0;
+    this->timer.start();
+}
+
+void Profiler::AddPhase(QString name)
+{
+    qint64 elapsed = this->timer.elapsed();
+
+    this->phase_List.append(qMakePair(name, elapsed - this->phase_Start));
+    this->phase_Start = elapsed;
+}
+
+qint64 Profiler::GetElapsed(void)
+{
+    return this->timer.elapsed();
+}
+
+QString Profiler::GetReport(QString title)
+{
+    QString report = title + ":\n";
+
+    for (const QPair<QString, qint64> &phase : this->phase_List)
+        report += "  " + phase.first + ": " + QString::number(phase.second) + "ms\n";
+
+    report += "  Total: " + QString::number(this->timer.elapsed()) + "ms";
+
+    return report;
+}
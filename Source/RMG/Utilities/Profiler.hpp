@@ -0,0 +1,39 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+namespace Utilities
+{
+class Profiler
+{
+  public:
+    Profiler(void);
+    ~Profiler(void);
+
+    void Start(void);
+    void AddPhase(QString);
+
+    qint64 GetElapsed(void);
+    QString GetReport(QString);
+
+  private:
+    QElapsedTimer timer;
+    qint64 phase_Start = 0;
+    QList<QPair<QString, qint64>> phase_List;
+};
+} // namespace Utilities
+
+#endif // PROFILER_HPP
@@ -0,0 +1,233 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "RewindBuffer.hpp"
+
+#include <QElapsedTimer>
+
+#include <cstring>
+
+using namespace Utilities;
+
+RewindBuffer::RewindBuffer(void)
+{
+}
+
+RewindBuffer::~RewindBuffer(void)
+{
+}
+
+void RewindBuffer::SetBudget(qint64 bytes)
+{
+    this->buffer_Budget = bytes;
+    this->buffer_Trim();
+}
+
+void RewindBuffer::Clear(void)
+{
+    this->buffer_Head.clear();
+    this->buffer_Deltas.clear();
+
+    this->stats_Count = 0;
+    this->stats_Size = 0;
+    this->stats_StateSize = 0;
+    this->stats_EncodeTime = 0;
+    this->stats_EncodeCount = 0;
+}
+
+void RewindBuffer::Push(QByteArray state)
+{
+    QElapsedTimer timer;
+    QByteArray delta;
+
+    timer.start();
+
+    // a different size means a different game
+    // or core, there's nothing to diff against
+    if (this->buffer_Head.size() != state.size())
+    {
+        this->Clear();
+    }
+    else
+    {
+        delta = delta_Encode(this->buffer_Head, state);
+        this->buffer_Deltas.append(delta);
+        this->stats_Size += delta.size();
+    }
+
+    this->stats_Size += state.size() - this->buffer_Head.size();
+    this->stats_StateSize = state.size();
+    this->buffer_Head = state;
+    this->buffer_Trim();
+
+    this->stats_Count = this->buffer_Deltas.size();
+    this->stats_EncodeTime += timer.nsecsElapsed();
+    this->stats_EncodeCount++;
+}
+
+bool RewindBuffer::Rewind(QByteArray *state)
+{
+    if (this->buffer_Deltas.isEmpty())
+        return false;
+
+    QByteArray delta = this->buffer_Deltas.takeLast();
+    this->stats_Size -= delta.size();
+    this->stats_Count = this->buffer_Deltas.size();
+
+    if (!delta_Apply(&this->buffer_Head, delta))
+    {
+        this->Clear();
+        return false;
+    }
+
+    *state = this->buffer_Head;
+    return true;
+}
+
+int RewindBuffer::GetCount(void)
+{
+    return this->stats_Count;
+}
+
+qint64 RewindBuffer::GetSize(void)
+{
+    return this->stats_Size;
+}
+
+qint64 RewindBuffer::GetStateSize(void)
+{
+    return this->stats_StateSize;
+}
+
+double RewindBuffer::GetEncodeTime(void)
+{
+    qint64 count = this->stats_EncodeCount;
+
+    if (count == 0)
+        return 0;
+
+    return (this->stats_EncodeTime / (double)count) / 1000000.0;
+}
+
+void RewindBuffer::buffer_Trim(void)
+{
+    // the newest state stays, even when it
+    // doesn't fit by itself
+    while (this->stats_Size > this->buffer_Budget && !this->buffer_Deltas.isEmpty())
+        this->stats_Size -= this->buffer_Deltas.takeFirst().size();
+
+    this->stats_Count = this->buffer_Deltas.size();
+}
+
+static inline quint64 delta_Word(const uchar *data)
+{
+    quint64 word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static inline void delta_PutNumber(QByteArray *delta, quint64 number)
+{
+    while (number >= 0x80)
+    {
+        delta->append((char)((number & 0x7F) | 0x80));
+        number >>= 7;
+    }
+
+    delta->append((char)number);
+}
+
+static inline bool delta_GetNumber(const uchar *delta, qint64 size, qint64 *pos, quint64 *number)
+{
+    *number = 0;
+
+    for (int shift = 0; *pos < size && shift < 64; shift += 7)
+    {
+        uchar byte = delta[(*pos)++];
+        *number |= (quint64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+QByteArray RewindBuffer::delta_Encode(const QByteArray &from, const QByteArray &to)
+{
+    const uchar *a = (const uchar *)from.constData();
+    const uchar *b = (const uchar *)to.constData();
+    qint64 size = from.size();
+    qint64 pos = 0, start, equal, literal;
+    int same;
+    QByteArray delta;
+
+    // a token is the amount of equal bytes to skip,
+    // followed by the amount of XOR'd bytes to copy
+    while (pos < size)
+    {
+        start = pos;
+        while (pos + 8 <= size && delta_Word(a + pos) == delta_Word(b + pos))
+            pos += 8;
+        while (pos < size && a[pos] == b[pos])
+            pos++;
+        equal = pos - start;
+
+        // a few equal bytes in the middle of changed ones
+        // cost less to copy than to start a new token for
+        start = pos;
+        same = 0;
+        while (pos < size && same < 8)
+        {
+            same = (a[pos] == b[pos]) ? same + 1 : 0;
+            pos++;
+        }
+        pos -= same;
+        literal = pos - start;
+
+        delta_PutNumber(&delta, equal);
+        delta_PutNumber(&delta, literal);
+
+        int offset = delta.size();
+        delta.resize(offset + literal);
+        uchar *out = (uchar *)delta.data() + offset;
+        for (qint64 i = 0; i < literal; i++)
+            out[i] = a[start + i] ^ b[start + i];
+    }
+
+    delta.squeeze();
+    return delta;
+}
+
+bool RewindBuffer::delta_Apply(QByteArray *state, const QByteArray &delta)
+{
+    uchar *s = (uchar *)state->data();
+    const uchar *d = (const uchar *)delta.constData();
+    qint64 size = state->size();
+    qint64 deltaSize = delta.size();
+    qint64 pos = 0, deltaPos = 0;
+    quint64 equal, literal;
+
+    while (deltaPos < deltaSize)
+    {
+        if (!delta_GetNumber(d, deltaSize, &deltaPos, &equal) || !delta_GetNumber(d, deltaSize, &deltaPos, &literal))
+            return false;
+
+        pos += equal;
+        if (pos + (qint64)literal > size || deltaPos + (qint64)literal > deltaSize)
+            return false;
+
+        for (quint64 i = 0; i < literal; i++)
+            s[pos + i] ^= d[deltaPos + i];
+
+        pos += literal;
+        deltaPos += literal;
+    }
+
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef REWINDBUFFER_HPP
+#define REWINDBUFFER_HPP
+
+#include <QByteArray>
+#include <QList>
+#include <QtGlobal>
+
+#include <atomic>
+
+namespace Utilities
+{
+// Ring buffer of savestates, only the newest one is kept whole,
+// every older one is stored as the XOR against its successor,
+// run-length encoded, consecutive states barely differ
+// so most of that is zero runs. Stepping back applies one delta.
+//
+// written by the emulation thread only,
+// the statistics can be read by any thread
+class RewindBuffer
+{
+  public:
+    RewindBuffer(void);
+    ~RewindBuffer(void);
+
+    void SetBudget(qint64);
+    void Clear(void);
+
+    void Push(QByteArray);
+    bool Rewind(QByteArray *);
+
+    int GetCount(void);
+    qint64 GetSize(void);
+    qint64 GetStateSize(void);
+    // milliseconds per Push
+    double GetEncodeTime(void);
+
+  private:
+    qint64 buffer_Budget = 0;
+
+    QByteArray buffer_Head;
+    // oldest first, delta i turns state i + 1 into state i
+    QList<QByteArray> buffer_Deltas;
+
+    std::atomic<int> stats_Count{0};
+    std::atomic<qint64> stats_Size{0};
+    std::atomic<qint64> stats_StateSize{0};
+    std::atomic<qint64> stats_EncodeTime{0};
+    std::atomic<qint64> stats_EncodeCount{0};
+
+    void buffer_Trim(void);
+
+    static QByteArray delta_Encode(const QByteArray &, const QByteArray &);
+    static bool delta_Apply(QByteArray *, const QByteArray &);
+};
+} // namespace Utilities
+
+#endif // REWINDBUFFER_HPP
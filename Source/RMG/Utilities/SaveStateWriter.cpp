@@ -0,0 +1,146 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SaveStateWriter.hpp"
+#include "../Config.hpp"
+#include "ThreadScheduler.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+using namespace Utilities;
+
+SaveStateWriter::SaveStateWriter(void)
+{
+}
+
+SaveStateWriter::~SaveStateWriter(void)
+{
+    if (!this->worker_Thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->worker_Mutex);
+        this->worker_Quit = true;
+    }
+
+    // pending writes still get written
+    this->worker_Condition.notify_all();
+    this->worker_Thread.join();
+}
+
+void SaveStateWriter::SetWriteCallback(std::function<void(QString, bool)> callback)
+{
+    std::lock_guard<std::mutex> lock(this->worker_Mutex);
+    this->worker_Callback = callback;
+}
+
+void SaveStateWriter::Write(QString file, QString sourceFile, QImage screen)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->worker_Mutex);
+
+        // a newer state for the same file makes
+        // the queued one pointless
+        for (int i = 0; i < this->worker_Queue.size(); i++)
+        {
+            if (this->worker_Queue.at(i).File == file)
+            {
+                this->worker_Queue.removeAt(i);
+                break;
+            }
+        }
+
+        this->worker_Queue.append({file, sourceFile, screen});
+
+        // started on first use, most sessions never save
+        if (!this->worker_Thread.joinable())
+            this->worker_Thread = std::thread(&SaveStateWriter::worker_Run, this);
+    }
+
+    this->worker_Condition.notify_all();
+}
+
+void SaveStateWriter::Wait(void)
+{
+    std::unique_lock<std::mutex> lock(this->worker_Mutex);
+    this->worker_Condition.wait(lock, [this] { return this->worker_Queue.isEmpty() && !this->worker_Busy; });
+}
+
+void SaveStateWriter::worker_Run(void)
+{
+    std::unique_lock<std::mutex> lock(this->worker_Mutex);
+    std::function<void(QString, bool)> callback;
+    ThreadScheduler scheduler;
+    Job_t job;
+    bool ret;
+
+    while (true)
+    {
+        this->worker_Condition.wait(lock, [this] { return this->worker_Quit || !this->worker_Queue.isEmpty(); });
+
+        if (this->worker_Queue.isEmpty())
+            break;
+
+        job = this->worker_Queue.takeFirst();
+        callback = this->worker_Callback;
+        this->worker_Busy = true;
+
+        lock.unlock();
+        // writing can wait for the game, the state
+        // itself was captured at full priority
+        scheduler.FollowBackground();
+        ret = job.SourceFile.isEmpty() || state_Copy(job.SourceFile, job.File);
+        if (ret)
+            thumbnail_Write(job.File, job.Screen);
+        if (callback)
+            callback(job.File, ret);
+        lock.lock();
+
+        this->worker_Busy = false;
+        this->worker_Condition.notify_all();
+    }
+}
+
+bool SaveStateWriter::state_Copy(QString sourceFile, QString file)
+{
+    QFile source(sourceFile);
+    QSaveFile saveFile(file);
+
+    if (!source.open(QIODevice::ReadOnly))
+        return false;
+
+    if (!QDir().mkpath(QFileInfo(file).absolutePath()))
+        return false;
+
+    // never leave a half written state behind
+    if (!saveFile.open(QIODevice::WriteOnly))
+        return false;
+
+    saveFile.write(source.readAll());
+    return saveFile.commit();
+}
+
+bool SaveStateWriter::thumbnail_Write(QString file, QImage screen)
+{
+    QString thumbnailFile = file + ".png";
+
+    // a stale thumbnail is worse than none
+    if (screen.isNull())
+    {
+        QFile::remove(thumbnailFile);
+        return false;
+    }
+
+    // the video plugin reads the screen bottom-up
+    QImage thumbnail = screen.mirrored().scaledToWidth(APP_SAVESTATE_THUMBNAIL_WIDTH, Qt::SmoothTransformation);
+    return thumbnail.save(thumbnailFile, "PNG");
+}
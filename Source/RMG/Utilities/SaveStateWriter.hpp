@@ -0,0 +1,66 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SAVESTATEWRITER_HPP
+#define SAVESTATEWRITER_HPP
+
+#include <QImage>
+#include <QList>
+#include <QString>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Utilities
+{
+// Writes what goes along with a savestate on a background thread,
+// the core compresses and writes the m64p state itself on its own
+// savestate thread, so neither costs the emulation thread any time,
+// reading the screen still happens there. the screenshot is written
+// downscaled next to the state (<file>.png), a captured state gets
+// copied to where the user decided to put it
+class SaveStateWriter
+{
+  public:
+    SaveStateWriter(void);
+    ~SaveStateWriter(void);
+
+    // called from the background thread once a write is done
+    void SetWriteCallback(std::function<void(QString, bool)>);
+
+    // copies the state from the second file first, when given
+    void Write(QString, QString, QImage);
+    void Wait(void);
+
+  private:
+    struct Job_t
+    {
+        QString File;
+        QString SourceFile;
+        QImage Screen;
+    };
+
+    std::mutex worker_Mutex;
+    std::condition_variable worker_Condition;
+    std::thread worker_Thread;
+    QList<Job_t> worker_Queue;
+    bool worker_Busy = false;
+    bool worker_Quit = false;
+    std::function<void(QString, bool)> worker_Callback;
+
+    void worker_Run(void);
+
+    static bool state_Copy(QString, QString);
+    static bool thumbnail_Write(QString, QImage);
+};
+} // namespace Utilities
+
+#endif // SAVESTATEWRITER_HPP
@@ -52,11 +52,35 @@ void Settings::LoadDefaults()
         }
     }
 
-    g_Plugins.LoadSettings();
-
     g_MupenApi.Config.Save();
 }
 
+void Settings::RestoreDefaults()
+{
+    Setting_t setting;
+    for (int i = 0; i < SettingsID::Invalid; i++)
+    {
+        setting = this->getSetting((SettingsID)i);
+
+        if (setting.Section.isEmpty())
+            continue;
+
+        switch (setting.Default.type())
+        {
+        case QVariant::Type::String:
+            this->setValue(setting, setting.Default.toString());
+            break;
+        case QVariant::Type::Int:
+            this->setValue(setting, setting.Default.toInt());
+            break;
+        default:
+        case QVariant::Type::Bool:
+            this->setValue(setting, setting.Default.toBool());
+            break;
+        }
+    }
+}
+
 int Settings::GetDefaultIntValue(SettingsID id)
 {
     return this->getDefaultIntValue(this->getSetting(id));
@@ -229,14 +253,78 @@ Setting_t Settings::getSetting(SettingsID id)
     case SettingsID::GUI_AllowManualResizing:
         setting = {GUI_SECTION, "Allow Manual Resizing", false, "", false};
         break;
-        /*
-        case SettingsID::GUI_PauseEmulationOnFocusLoss:
-            setting = {GUI_SECTION, "PauseEmulationOnFocusLoss", true, "", false};
-            break;
-        case SettingsID::GUI_ResumeEmulationOnFocus:
-            setting = {GUI_SECTION, "ResumeEmulationOnFocus", true, "", false};
-            break;
-        */
+    case SettingsID::GUI_OffscreenRendering:
+        setting = {GUI_SECTION, "Offscreen Rendering", false, "", false};
+        break;
+    case SettingsID::GUI_NativeRenderWindow:
+        setting = {GUI_SECTION, "Native Render Window", false, "", false};
+        break;
+    case SettingsID::GUI_NativeRenderFullscreen:
+        setting = {GUI_SECTION, "Native Render Window Fullscreen", false, "", false};
+        break;
+    case SettingsID::GUI_SwapInterval:
+        setting = {GUI_SECTION, "Swap Interval", -1, "", false};
+        break;
+    case SettingsID::GUI_MatchRefreshRate:
+        setting = {GUI_SECTION, "Match Refresh Rate", false, "", false};
+        break;
+    case SettingsID::GUI_ShowFrameTimeGraph:
+        setting = {GUI_SECTION, "Show Frame Time Graph", false, "", false};
+        break;
+    case SettingsID::GUI_ScaleOnResize:
+        setting = {GUI_SECTION, "Scale On Resize", false, "", false};
+        break;
+    case SettingsID::GUI_ScaleFilter:
+        setting = {GUI_SECTION, "Scale Filter", 0, "", false};
+        break;
+    case SettingsID::GUI_ShowStatsOverlay:
+        setting = {GUI_SECTION, "Show Performance Overlay", false, "", false};
+        break;
+    case SettingsID::GUI_MuteAudioWhenFast:
+        setting = {GUI_SECTION, "Mute Audio When Fast", true, "", false};
+        break;
+    case SettingsID::GUI_RewindEnabled:
+        setting = {GUI_SECTION, "Rewind Enabled", false, "", false};
+        break;
+    case SettingsID::GUI_RewindBufferSize:
+        setting = {GUI_SECTION, "Rewind Buffer Size", 64, "", false};
+        break;
+    case SettingsID::GUI_RewindInterval:
+        setting = {GUI_SECTION, "Rewind Interval", 4, "", false};
+        break;
+    case SettingsID::GUI_SuspendOnExit:
+        setting = {GUI_SECTION, "Suspend On Exit", true, "", false};
+        break;
+    case SettingsID::GUI_HangTimeout:
+        setting = {GUI_SECTION, "Hang Timeout", 10, "", false};
+        break;
+    case SettingsID::GUI_CpuAffinity:
+        setting = {GUI_SECTION, "CPU Affinity", "", "", false};
+        break;
+    case SettingsID::GUI_RealtimePriority:
+        setting = {GUI_SECTION, "Realtime Priority", false, "", false};
+        break;
+    case SettingsID::GUI_Nice:
+        setting = {GUI_SECTION, "Nice", 0, "", false};
+        break;
+    case SettingsID::GUI_LockMemory:
+        setting = {GUI_SECTION, "Lock Memory", false, "", false};
+        break;
+    case SettingsID::GUI_DemoteBackground:
+        setting = {GUI_SECTION, "Demote Background Threads", true, "", false};
+        break;
+    case SettingsID::GUI_IdlePolicy:
+        setting = {GUI_SECTION, "Idle Policy", 0, "", false};
+        break;
+    case SettingsID::GUI_IdleSpeed:
+        setting = {GUI_SECTION, "Idle Speed", 25, "", false};
+        break;
+    case SettingsID::GUI_PauseEmulationOnFocusLoss:
+        setting = {GUI_SECTION, "PauseEmulationOnFocusLoss", false, "", false};
+        break;
+    case SettingsID::GUI_ResumeEmulationOnFocus:
+        setting = {GUI_SECTION, "ResumeEmulationOnFocus", true, "", false};
+        break;
 
     case SettingsID::Core_GFX_Plugin:
         setting = {CORE_SECTION, "GFX Plugin", "", "", false};
@@ -319,6 +407,9 @@ Setting_t Settings::getSetting(SettingsID id)
     case SettingsID::Game_RandomizeInterrupt:
         setting = {"", "Core_RandomizeInterrupt", true, "", false};
         break;
+    case SettingsID::Game_RunAheadFrames:
+        setting = {"", "RunAheadFrames", 0, "", false};
+        break;
 
     case SettingsID::Game_GFX_Plugin:
         setting = {"", "GFX Plugin", "", "", false};
@@ -366,6 +457,18 @@ Setting_t Settings::getSetting(SettingsID id)
     case SettingsID::KeyBinding_LimitFPS:
         setting = {KEYBIND_SECTION, "LimitFPS", "F4", "", false};
         break;
+    case SettingsID::KeyBinding_FastForward:
+        setting = {KEYBIND_SECTION, "FastForward", "Tab", "", false};
+        break;
+    case SettingsID::KeyBinding_IncreaseSpeed:
+        setting = {KEYBIND_SECTION, "IncreaseSpeed", "Ctrl+Up", "", false};
+        break;
+    case SettingsID::KeyBinding_DecreaseSpeed:
+        setting = {KEYBIND_SECTION, "DecreaseSpeed", "Ctrl+Down", "", false};
+        break;
+    case SettingsID::KeyBinding_Rewind:
+        setting = {KEYBIND_SECTION, "Rewind", "Backspace", "", false};
+        break;
     case SettingsID::KeyBinding_SwapDisk:
         setting = {KEYBIND_SECTION, "SwapDisk", "Ctrl+D", "", false};
         break;
@@ -22,6 +22,8 @@ class Settings
     ~Settings();
 
     void LoadDefaults(void);
+    // saves the config, like SetValue does
+    void RestoreDefaults(void);
 
     int GetDefaultIntValue(SettingsID);
     bool GetDefaultBoolValue(SettingsID);
@@ -32,10 +32,30 @@ enum SettingsID
     GUI_SettingsDialogWidth,
     GUI_SettingsDialogHeight,
     GUI_AllowManualResizing,
-    /*
+    GUI_OffscreenRendering,
+    GUI_NativeRenderWindow,
+    GUI_NativeRenderFullscreen,
+    GUI_SwapInterval,
+    GUI_MatchRefreshRate,
+    GUI_ShowFrameTimeGraph,
+    GUI_ScaleOnResize,
+    GUI_ScaleFilter,
+    GUI_ShowStatsOverlay,
+    GUI_MuteAudioWhenFast,
+    GUI_RewindEnabled,
+    GUI_RewindBufferSize,
+    GUI_RewindInterval,
+    GUI_SuspendOnExit,
+    GUI_HangTimeout,
+    GUI_CpuAffinity,
+    GUI_RealtimePriority,
+    GUI_Nice,
+    GUI_LockMemory,
+    GUI_DemoteBackground,
+    GUI_IdlePolicy,
+    GUI_IdleSpeed,
     GUI_PauseEmulationOnFocusLoss,
     GUI_ResumeEmulationOnFocus,
-    */
 
     // Core Plugin Settings
     Core_GFX_Plugin,
@@ -73,6 +93,7 @@ enum SettingsID
     Game_OverrideCoreSettings,
     Game_CPU_Emulator,
     Game_RandomizeInterrupt,
+    Game_RunAheadFrames,
 
     // Game Plugin Settings
     Game_GFX_Plugin,
@@ -92,6 +113,10 @@ enum SettingsID
     KeyBinding_Resume,
     KeyBinding_GenerateBitmap,
     KeyBinding_LimitFPS,
+    KeyBinding_FastForward,
+    KeyBinding_IncreaseSpeed,
+    KeyBinding_DecreaseSpeed,
+    KeyBinding_Rewind,
     KeyBinding_SwapDisk,
     KeyBinding_SaveState,
     KeyBinding_SaveAs,
@@ -0,0 +1,76 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ThreadClock.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+using namespace Utilities;
+
+ThreadClock::ThreadClock(void)
+{
+}
+
+ThreadClock::~ThreadClock(void)
+{
+#ifdef _WIN32
+    if (this->clock_Thread != nullptr)
+        CloseHandle(this->clock_Thread);
+#endif
+}
+
+bool ThreadClock::Attach(void)
+{
+    this->clock_Valid = false;
+
+#ifdef _WIN32
+    // the old handle stays valid until now,
+    // readers stop before a new thread attaches
+    if (this->clock_Thread != nullptr)
+        CloseHandle(this->clock_Thread);
+    this->clock_Thread = nullptr;
+
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), (HANDLE *)&this->clock_Thread,
+                         THREAD_QUERY_LIMITED_INFORMATION, FALSE, 0))
+        return false;
+#else
+    if (pthread_getcpuclockid(pthread_self(), &this->clock_Id) != 0)
+        return false;
+#endif
+
+    this->clock_Valid = true;
+    return true;
+}
+
+qint64 ThreadClock::GetTime(void)
+{
+    if (!this->clock_Valid)
+        return -1;
+
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(this->clock_Thread, &creation, &exit, &kernel, &user))
+        return -1;
+
+    // 100ns units
+    quint64 total = ((quint64)kernel.dwHighDateTime << 32 | kernel.dwLowDateTime) +
+                    ((quint64)user.dwHighDateTime << 32 | user.dwLowDateTime);
+    return (qint64)total * 100;
+#else
+    struct timespec time;
+    if (clock_gettime(this->clock_Id, &time) != 0)
+        return -1;
+
+    return (qint64)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
@@ -0,0 +1,47 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef THREADCLOCK_HPP
+#define THREADCLOCK_HPP
+
+#include <QtGlobal>
+
+#include <atomic>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace Utilities
+{
+// CPU time used by one thread,
+// attached from that thread, read from any thread
+class ThreadClock
+{
+  public:
+    ThreadClock(void);
+    ~ThreadClock(void);
+
+    bool Attach(void);
+
+    // nanoseconds, -1 when unknown
+    qint64 GetTime(void);
+
+  private:
+    std::atomic<bool> clock_Valid{false};
+
+#ifdef _WIN32
+    void *clock_Thread = nullptr;
+#else
+    clockid_t clock_Id;
+#endif
+};
+} // namespace Utilities
+
+#endif // THREADCLOCK_HPP
@@ -0,0 +1,161 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ThreadDump.hpp"
+#include "../Config.hpp"
+
+#ifdef __linux__
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+
+#include <atomic>
+
+#include <execinfo.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define DUMP_SIGNAL (SIGRTMIN + 3)
+#define DUMP_FRAMES_MAX 64
+
+static void *dump_Frames[DUMP_FRAMES_MAX];
+static std::atomic<int> dump_FrameCount{-1};
+static std::atomic<long> dump_Target{0};
+
+static void dump_SignalHandler(int)
+{
+    // a thread that answers too late must not
+    // overwrite the stack of the next one
+    if (syscall(SYS_gettid) != dump_Target)
+        return;
+
+    dump_FrameCount = backtrace(dump_Frames, DUMP_FRAMES_MAX);
+}
+#endif // __linux__
+
+using namespace Utilities;
+
+ThreadDump::ThreadDump(void)
+{
+}
+
+ThreadDump::~ThreadDump(void)
+{
+}
+
+bool ThreadDump::Init(void)
+{
+#ifdef __linux__
+    struct sigaction action = {};
+
+    // the first backtrace() loads libgcc,
+    // which isn't safe in a signal handler
+    backtrace(dump_Frames, 1);
+
+    action.sa_handler = dump_SignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(DUMP_SIGNAL, &action, nullptr) != 0)
+    {
+        this->error_Message = "ThreadDump::Init: sigaction Failed";
+        return false;
+    }
+
+    this->init_Done = true;
+    return true;
+#else
+    this->error_Message = "ThreadDump::Init: not supported on this platform";
+    return false;
+#endif
+}
+
+bool ThreadDump::Capture(void)
+{
+    this->dump_Report.clear();
+
+    if (!this->init_Done)
+    {
+        this->error_Message = "ThreadDump::Capture: not initialized";
+        return false;
+    }
+
+#ifdef __linux__
+    QDir taskDir("/proc/self/task");
+    long self = syscall(SYS_gettid);
+
+    for (const QString &task : taskDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        long tid = task.toLong();
+        QFile commFile(taskDir.filePath(task + "/comm"));
+        QString name;
+        QElapsedTimer timer;
+        char **symbols;
+        int count;
+
+        if (commFile.open(QIODevice::ReadOnly))
+            name = QString(commFile.readAll()).trimmed();
+
+        this->dump_Report += "Thread " + task + " (" + name + ")";
+        this->dump_Report += tid == self ? ", capturing:\n" : ":\n";
+
+        dump_FrameCount = -1;
+        dump_Target = tid;
+
+        if (syscall(SYS_tgkill, getpid(), tid, DUMP_SIGNAL) != 0)
+        {
+            this->dump_Report += "  gone\n";
+            continue;
+        }
+
+        // a thread blocked in the kernel
+        // only runs the handler once it returns
+        timer.start();
+        while (dump_FrameCount < 0 && timer.elapsed() < APP_THREADDUMP_TIMEOUT)
+            QThread::msleep(1);
+
+        count = dump_FrameCount;
+        dump_Target = 0;
+
+        if (count < 0)
+        {
+            this->dump_Report += "  no response within " + QString::number(APP_THREADDUMP_TIMEOUT) + "ms\n";
+            continue;
+        }
+
+        symbols = backtrace_symbols(dump_Frames, count);
+        if (symbols == nullptr)
+            continue;
+
+        // skip the handler and the signal trampoline
+        for (int i = 2; i < count; i++)
+            this->dump_Report += "  #" + QString::number(i - 2) + " " + symbols[i] + "\n";
+
+        free(symbols);
+    }
+
+    return true;
+#else
+    this->error_Message = "ThreadDump::Capture: not supported on this platform";
+    return false;
+#endif
+}
+
+QString ThreadDump::GetReport(void)
+{
+    return this->dump_Report;
+}
+
+QString ThreadDump::GetLastError(void)
+{
+    return this->error_Message;
+}
@@ -0,0 +1,43 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef THREADDUMP_HPP
+#define THREADDUMP_HPP
+
+#include <QString>
+
+namespace Utilities
+{
+// Backtraces of every thread in the process, each thread
+// is interrupted by a signal and records its own stack,
+// so a deadlocked thread can still be inspected
+class ThreadDump
+{
+  public:
+    ThreadDump(void);
+    ~ThreadDump(void);
+
+    // installs the signal handler,
+    // before any thread can hang
+    bool Init(void);
+
+    bool Capture(void);
+    QString GetReport(void);
+
+    QString GetLastError(void);
+
+  private:
+    bool init_Done = false;
+
+    QString error_Message;
+    QString dump_Report;
+};
+} // namespace Utilities
+
+#endif // THREADDUMP_HPP
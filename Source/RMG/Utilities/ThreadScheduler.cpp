@@ -0,0 +1,304 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ThreadScheduler.hpp"
+
+#include <QStringList>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#include <QDir>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#define IDLE_NICE 19
+#endif
+
+using namespace Utilities;
+
+std::atomic<bool> ThreadScheduler::background_Idle{false};
+
+ThreadScheduler::ThreadScheduler(void)
+{
+}
+
+ThreadScheduler::~ThreadScheduler(void)
+{
+}
+
+QList<int> ThreadScheduler::ParseCpuList(QString text)
+{
+    QList<int> cpus;
+
+    for (const QString &part : text.split(',', QString::SkipEmptyParts))
+    {
+        QStringList range = part.trimmed().split('-');
+        bool firstOk = false, lastOk = false;
+        int first = range.first().toInt(&firstOk);
+        int last = range.last().toInt(&lastOk);
+
+        if (!firstOk || !lastOk || range.size() > 2 || first < 0 || last < first)
+            continue;
+
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            if (!cpus.contains(cpu))
+                cpus.append(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+bool ThreadScheduler::SetAffinity(QList<int> cpus)
+{
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+
+    for (int cpu : cpus)
+    {
+        if (cpu < (int)sizeof(DWORD_PTR) * 8)
+            mask |= (DWORD_PTR)1 << cpu;
+    }
+
+    if (mask == 0)
+        mask = ~(DWORD_PTR)0;
+
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+    {
+        this->error_Message = "ThreadScheduler::SetAffinity: SetThreadAffinityMask Failed";
+        return false;
+    }
+
+    return true;
+#elif defined(__linux__)
+    return this->SetAffinity(syscall(SYS_gettid), cpus);
+#else
+    this->error_Message = "ThreadScheduler::SetAffinity: not supported on this platform";
+    return cpus.isEmpty();
+#endif
+}
+
+bool ThreadScheduler::SetAffinity(qint64 thread, QList<int> cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+
+    // an empty list gives the thread every core back
+    if (cpus.isEmpty())
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &set);
+    }
+
+    if (sched_setaffinity((pid_t)thread, sizeof(set), &set) != 0)
+    {
+        this->error_Message = "ThreadScheduler::SetAffinity: sched_setaffinity Failed: ";
+        this->error_Message += strerror(errno);
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED(thread);
+    this->error_Message = "ThreadScheduler::SetAffinity: not supported on this platform";
+    return cpus.isEmpty();
+#endif
+}
+
+bool ThreadScheduler::SetRealtime(void)
+{
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        this->error_Message = "ThreadScheduler::SetRealtime: SetThreadPriority Failed";
+        return false;
+    }
+
+    return true;
+#else
+    struct sched_param param = {};
+    int ret;
+
+    // the lowest real-time priority still
+    // preempts every normal thread
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+    ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0)
+    {
+        this->error_Message = "ThreadScheduler::SetRealtime: pthread_setschedparam Failed: ";
+        this->error_Message += strerror(ret);
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+bool ThreadScheduler::SetNice(int nice)
+{
+#ifdef __linux__
+    // per thread on Linux, despite what POSIX says
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice) != 0)
+    {
+        this->error_Message = "ThreadScheduler::SetNice: setpriority Failed: ";
+        this->error_Message += strerror(errno);
+        return false;
+    }
+
+    return true;
+#else
+    this->error_Message = "ThreadScheduler::SetNice: not supported on this platform";
+    return nice == 0;
+#endif
+}
+
+bool ThreadScheduler::SetIdle(bool idle)
+{
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), idle ? THREAD_PRIORITY_IDLE : THREAD_PRIORITY_NORMAL))
+    {
+        this->error_Message = "ThreadScheduler::SetIdle: SetThreadPriority Failed";
+        return false;
+    }
+#elif defined(__linux__)
+    struct sched_param param = {};
+    struct rlimit limit;
+    pid_t thread = syscall(SYS_gettid);
+    int nice;
+
+    // SCHED_IDLE, or a raised nice value, can't be undone
+    // without privileges, SCHED_BATCH can, so the nice value
+    // is only raised when RLIMIT_NICE allows lowering it again
+    if (!idle && this->thread_NiceRaised)
+    {
+        if (setpriority(PRIO_PROCESS, thread, this->thread_Nice) != 0)
+        {
+            this->error_Message = "ThreadScheduler::SetIdle: setpriority Failed: ";
+            this->error_Message += strerror(errno);
+            return false;
+        }
+
+        this->thread_NiceRaised = false;
+    }
+
+    if (sched_setscheduler(0, idle ? SCHED_BATCH : SCHED_OTHER, &param) != 0)
+    {
+        this->error_Message = "ThreadScheduler::SetIdle: sched_setscheduler Failed: ";
+        this->error_Message += strerror(errno);
+        return false;
+    }
+
+    if (idle)
+    {
+        errno = 0;
+        nice = getpriority(PRIO_PROCESS, thread);
+
+        if (errno == 0 && nice < IDLE_NICE && getrlimit(RLIMIT_NICE, &limit) == 0 &&
+            (limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= (rlim_t)(20 - nice)) &&
+            setpriority(PRIO_PROCESS, thread, IDLE_NICE) == 0)
+        {
+            this->thread_Nice = nice;
+            this->thread_NiceRaised = true;
+        }
+    }
+#else
+    this->error_Message = "ThreadScheduler::SetIdle: not supported on this platform";
+    return !idle;
+#endif
+
+    this->thread_Idle = idle;
+    return true;
+}
+
+bool ThreadScheduler::LockMemory(bool lock)
+{
+#ifdef _WIN32
+    this->error_Message = "ThreadScheduler::LockMemory: not supported on this platform";
+    return !lock;
+#else
+    int ret = lock ? mlockall(MCL_CURRENT | MCL_FUTURE) : munlockall();
+    if (ret != 0)
+    {
+        this->error_Message = "ThreadScheduler::LockMemory: ";
+        this->error_Message += lock ? "mlockall" : "munlockall";
+        this->error_Message += " Failed: ";
+        this->error_Message += strerror(errno);
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+QList<qint64> ThreadScheduler::TakeNewThreads(void)
+{
+    QList<qint64> threads;
+
+#ifdef __linux__
+    QDir taskDir("/proc/self/task");
+    QSet<qint64> current;
+
+    for (const QString &task : taskDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        qint64 thread = task.toLongLong();
+
+        current.insert(thread);
+        if (!this->thread_Known.contains(thread))
+            threads.append(thread);
+    }
+
+    this->thread_Known = current;
+#endif
+
+    return threads;
+}
+
+void ThreadScheduler::SetBackgroundIdle(bool idle)
+{
+    background_Idle = idle;
+}
+
+void ThreadScheduler::FollowBackground(void)
+{
+    bool idle = background_Idle;
+
+    if (idle == this->thread_Idle)
+        return;
+
+    // nothing to do about a failure, the worker keeps
+    // the priority it has and tries again next time
+    this->SetIdle(idle);
+}
+
+QString ThreadScheduler::GetLastError(void)
+{
+    return this->error_Message;
+}
@@ -0,0 +1,63 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef THREADSCHEDULER_HPP
+#define THREADSCHEDULER_HPP
+
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include <atomic>
+
+namespace Utilities
+{
+// Scheduling of the calling thread, unless a thread id is given,
+// those only work on Linux where thread ids are process ids
+class ThreadScheduler
+{
+  public:
+    ThreadScheduler(void);
+    ~ThreadScheduler(void);
+
+    // "0,2-3" style lists, empty means every core
+    static QList<int> ParseCpuList(QString);
+
+    bool SetAffinity(QList<int>);
+    bool SetAffinity(qint64, QList<int>);
+    bool SetRealtime(void);
+    bool SetNice(int);
+    bool SetIdle(bool);
+
+    // the whole process
+    bool LockMemory(bool);
+
+    // threads started since the previous call
+    QList<qint64> TakeNewThreads(void);
+
+    // background workers follow this at their
+    // own pace, through FollowBackground()
+    static void SetBackgroundIdle(bool);
+    void FollowBackground(void);
+
+    QString GetLastError(void);
+
+  private:
+    QString error_Message;
+
+    QSet<qint64> thread_Known;
+    bool thread_Idle = false;
+    bool thread_NiceRaised = false;
+    int thread_Nice = 0;
+
+    static std::atomic<bool> background_Idle;
+};
+} // namespace Utilities
+
+#endif // THREADSCHEDULER_HPP
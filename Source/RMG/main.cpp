@@ -5,6 +5,10 @@
 
 int main(int argc, char **argv)
 {
+    // needed for the offscreen render context to share
+    // its frames with the GUI thread
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
     QApplication app(argc, argv);
 
     UserInterface::MainWindow window;